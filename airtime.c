@@ -0,0 +1,240 @@
+/* Airtime accounting and rate limiting
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "clock.h"
+#include "airtime.h"
+#include "telemetry.h"
+#include "config.h"
+
+struct bucket {
+	uint16_t permille;	// refill, 0 = unlimited
+	uint16_t burst;		// ms
+	int32_t tokens;		// us
+	uint32_t last;		// clock_ms() of the last refill
+};
+
+struct airtime_count {
+	uint32_t ms;
+	uint16_t us;
+	uint16_t frames;
+	uint16_t rejected;
+};
+
+struct airtime_dest {
+	uint8_t addr;
+	uint8_t used;
+	struct bucket bucket;
+	struct airtime_count count;
+};
+
+struct airtime_limits airtime_limits = {
+	AIRTIME_BAND_PERMILLE, AIRTIME_BAND_BURST,
+	AIRTIME_DEST_PERMILLE, AIRTIME_DEST_BURST, AIRTIME_QUEUE
+};
+
+static uint16_t rf_baudrate;
+static struct bucket band;
+static struct airtime_count band_count;
+static struct airtime_dest dests[AIRTIME_DESTS];
+
+static void bucket_init(struct bucket *b, uint16_t permille, uint16_t burst)
+{
+	b->permille = permille;
+	b->burst = burst;
+	b->tokens = burst * 1000L;
+	b->last = clock_ms();
+}
+
+static void bucket_refill(struct bucket *b, uint32_t now)
+{
+	uint32_t full = b->burst * 1000UL;
+	uint32_t ms = now - b->last;
+
+	b->last = now;
+	if(!b->permille)
+		return;
+	/* from empty to full takes full/permille ms, longer idle times
+	 * would overflow the product */
+	if(ms > full / b->permille)
+		b->tokens = full;
+	else
+		b->tokens += ms * b->permille;
+	if(b->tokens > (int32_t)full)
+		b->tokens = full;
+}
+
+/* 0 if the bucket can't pay for us microseconds of airtime */
+static uint8_t bucket_check(struct bucket *b, uint32_t us)
+{
+	return !b->permille || b->tokens >= (int32_t)us;
+}
+
+static void bucket_take(struct bucket *b, uint32_t us)
+{
+	if(b->permille)
+		b->tokens -= us;
+}
+
+static void count_add(struct airtime_count *c, uint32_t us)
+{
+	us += c->us;
+	c->ms += us / 1000;
+	c->us = us % 1000;
+	c->frames++;
+}
+
+/* a new rf rate, limits and counts so far stay as they are */
+void airtime_set_rate(uint16_t baudrate)
+{
+	rf_baudrate = baudrate;
+}
+
+void airtime_init(uint16_t baudrate)
+{
+	rf_baudrate = baudrate;
+	memset(dests, 0, sizeof(dests));
+	memset(&band_count, 0, sizeof(band_count));
+	/* airtime_limits is what the config log loaded */
+	bucket_init(&band, airtime_limits.band_permille, airtime_limits.band_burst);
+}
+
+uint32_t airtime_frame_us(uint8_t len)
+{
+	return (len + AIRTIME_OVERHEAD) * 8000000UL / rf_baudrate;
+}
+
+void airtime_config(uint8_t scope, uint16_t permille, uint16_t burst, uint8_t policy)
+{
+	uint8_t i;
+
+	if(permille > 1000)
+		permille = 1000;
+	airtime_limits.policy = policy;
+	if(scope == AIRTIME_SCOPE_BAND)
+	{
+		airtime_limits.band_permille = permille;
+		airtime_limits.band_burst = burst;
+		bucket_init(&band, permille, burst);
+	}
+	else
+	{
+		airtime_limits.dest_permille = permille;
+		airtime_limits.dest_burst = burst;
+		for(i=0;i<AIRTIME_DESTS;i++)
+			bucket_init(&dests[i].bucket, permille, burst);
+	}
+	config_save();
+}
+
+/* 0 if a frame of len bytes costs more than a full bucket holds, it
+ * would wait for tokens forever */
+uint8_t airtime_fits(uint8_t len)
+{
+	uint32_t us = airtime_frame_us(len);
+
+	return (!band.permille || us <= band.burst * 1000UL) &&
+		(!airtime_limits.dest_permille || us <= airtime_limits.dest_burst * 1000UL);
+}
+
+static struct airtime_dest *airtime_find(uint8_t dst)
+{
+	uint8_t i;
+
+	for(i=0;i<AIRTIME_DESTS;i++)
+		if(dests[i].used && dests[i].addr == dst)
+			return &dests[i];
+	return 0;
+}
+
+/* counters for dst, the least busy entry is recycled if dst is new */
+static struct airtime_dest *airtime_dest(uint8_t dst)
+{
+	uint8_t i;
+	struct airtime_dest *d = airtime_find(dst);
+
+	if(d)
+		return d;
+	d = &dests[0];
+	for(i=0;i<AIRTIME_DESTS && d->used;i++)
+		if(!dests[i].used || dests[i].count.frames < d->count.frames)
+			d = &dests[i];
+	memset(d, 0, sizeof(*d));
+	d->addr = dst;
+	d->used = 1;
+	bucket_init(&d->bucket, airtime_limits.dest_permille, airtime_limits.dest_burst);
+	return d;
+}
+
+/* charges the frame and returns 1 if it may be sent now. A
+ * destination gets an entry only when a frame for it is charged, a new
+ * one starts with a full bucket. */
+uint8_t airtime_grant(uint8_t dst, uint8_t len)
+{
+	uint32_t now = clock_ms();
+	uint32_t us = airtime_frame_us(len);
+	struct airtime_dest *d = airtime_find(dst);
+
+	bucket_refill(&band, now);
+	if(d)
+		bucket_refill(&d->bucket, now);
+	if(!bucket_check(&band, us))
+		return 0;
+	if(d ? !bucket_check(&d->bucket, us) :
+		airtime_limits.dest_permille && us > airtime_limits.dest_burst * 1000UL)
+		return 0;
+
+	if(!d)
+		d = airtime_dest(dst);
+	bucket_take(&band, us);
+	bucket_take(&d->bucket, us);
+	count_add(&band_count, us);
+	count_add(&d->count, us);
+	return 1;
+}
+
+void airtime_reject(uint8_t dst)
+{
+	struct airtime_dest *d = airtime_find(dst);
+
+	band_count.rejected++;
+	if(d)
+		d->count.rejected++;
+	printf_P(PSTR("10;19;%d\r\n"),dst);
+}
+
+/* 10;20;uptime s;airtime ms;frames;rejected  whole band
+ * 10;21;dst;airtime ms;frames;rejected      per destination */
+void airtime_report(void)
+{
+	uint8_t i;
+
+	fprintf_P(telemetry,PSTR("10;20;%lu;%lu;%u;%u\r\n"),clock_ms()/1000,band_count.ms,
+		band_count.frames,band_count.rejected);
+	for(i=0;i<AIRTIME_DESTS;i++)
+		if(dests[i].used)
+			fprintf_P(telemetry,PSTR("10;21;%d;%lu;%u;%u\r\n"),dests[i].addr,dests[i].count.ms,
+				dests[i].count.frames,dests[i].count.rejected);
+}
@@ -0,0 +1,65 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_AIRTIME_H__
+#define __DEFINE_AIRTIME_H__
+
+/* Airtime accounting and token buckets
+ *
+ * Every frame is charged with the time it occupies the band. A bucket
+ * for the whole band and one per destination are refilled with
+ * "permille" microseconds per millisecond, up to "burst" ms of airtime.
+ * permille 0 switches a bucket off. A frame that costs more than a full
+ * bucket can never be paid for, it is rejected whatever the policy. */
+#define AIRTIME_OVERHEAD	11		// preamble, sync, rf12 header and crc bytes
+#define AIRTIME_DESTS		4		// destinations with own counters
+#define AIRTIME_BAND_PERMILLE	100	// 10% duty cycle for 433MHz
+#define AIRTIME_BAND_BURST	1000	// ms
+#define AIRTIME_DEST_PERMILLE	0
+#define AIRTIME_DEST_BURST	1000	// ms
+
+#define AIRTIME_SCOPE_BAND	0
+#define AIRTIME_SCOPE_DEST	1
+
+#define AIRTIME_QUEUE		0		// excess frames wait for tokens
+#define AIRTIME_REJECT		1		// excess frames are dropped
+
+/* kept in the config log (see config.h) */
+struct airtime_limits {
+	uint16_t band_permille;
+	uint16_t band_burst;
+	uint16_t dest_permille;
+	uint16_t dest_burst;
+	uint8_t policy;
+};
+
+extern struct airtime_limits airtime_limits;
+
+extern void airtime_init(uint16_t baudrate);
+extern void airtime_set_rate(uint16_t baudrate);
+extern uint32_t airtime_frame_us(uint8_t len);
+extern void airtime_config(uint8_t scope, uint16_t permille, uint16_t burst, uint8_t policy);
+extern uint8_t airtime_fits(uint8_t len);
+extern uint8_t airtime_grant(uint8_t dst, uint8_t len);
+extern void airtime_reject(uint8_t dst);
+extern void airtime_report(void);
+
+#endif
@@ -0,0 +1,188 @@
+/* Authenticated RF frames
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "main.h"
+#include "clock.h"
+#include "net.h"
+#include "airtime.h"
+#include "auth.h"
+#include "telemetry.h"
+
+#ifdef USE_AUTH
+
+#define XTEA_DELTA 0x9E3779B9UL
+
+struct auth_node {
+	uint8_t node;		// 0 = free
+	uint32_t counter;	// last accepted, in the eeprom the floor
+};
+
+static uint8_t ee_key[16] EEMEM;
+static uint16_t ee_counter EEMEM;
+static struct auth_node ee_nodes[AUTH_NODES] EEMEM;
+
+/* the round keys are worked out in every cycle, a table of them
+ * would take 256 bytes */
+static uint32_t key[4];
+static uint32_t tx_counter;
+static struct auth_node nodes[AUTH_NODES];
+
+void auth_init(void)
+{
+	uint16_t hi;
+	uint8_t i;
+
+	eeprom_read_block(key, ee_key, sizeof(key));
+	/* never reuse a counter, skip whatever the last run might have used */
+	hi = eeprom_read_word(&ee_counter) + 1;
+	eeprom_write_word(&ee_counter, hi);
+	tx_counter = (uint32_t)hi << 16;
+	eeprom_read_block(nodes, ee_nodes, sizeof(nodes));
+	/* erased eeprom */
+	for(i=0;i<AUTH_NODES;i++)
+		if(NET_IS_MULTI(nodes[i].node))
+			nodes[i].node = 0;
+}
+
+/* the old counters mean nothing with a new key */
+void auth_set_key(uint8_t *new_key)
+{
+	memcpy(key, new_key, sizeof(key));
+	eeprom_write_block(key, ee_key, sizeof(key));
+	memset(nodes, 0, sizeof(nodes));
+	eeprom_write_block(nodes, ee_nodes, sizeof(nodes));
+}
+
+static void xtea(uint32_t *v)
+{
+	uint32_t v0 = v[0], v1 = v[1], sum = 0;
+	uint8_t i;
+
+	for(i=0;i<32;i++)
+	{
+		v0 += (((v1 << 4) ^ (v1 >> 5)) + v1) ^ (sum + key[sum & 3]);
+		sum += XTEA_DELTA;
+		v1 += (((v0 << 4) ^ (v0 >> 5)) + v0) ^ (sum + key[(sum >> 11) & 3]);
+	}
+	v[0] = v0;
+	v[1] = v1;
+}
+
+static void auth_mac(uint8_t *frame, uint8_t len, uint8_t *mac)
+{
+	uint32_t v[2] = {0, 0};
+	uint8_t *b = (uint8_t*)v;
+	uint8_t i, j;
+
+	for(i=0;i<len;i+=8)
+	{
+		for(j=0;j<8 && i+j<len;j++)
+			if(i+j != offsetof(struct net_header, ttl) &&
+				i+j != offsetof(struct net_header, hops))
+				b[j] ^= frame[i+j];
+		xtea(v);
+	}
+	memcpy(mac, v, AUTH_MAC_SIZE);
+}
+
+/* header has to be complete, len including AUTH_SIZE */
+void auth_sign(uint8_t *frame)
+{
+	struct net_header *hdr = (struct net_header*)frame;
+	uint8_t *c = &frame[NET_HEADER_SIZE + hdr->len - AUTH_SIZE];
+
+	c[0] = tx_counter >> 24;
+	c[1] = tx_counter >> 16;
+	c[2] = tx_counter >> 8;
+	c[3] = tx_counter;
+	if(!(uint16_t)++tx_counter)
+		eeprom_write_word(&ee_counter, tx_counter >> 16);
+	auth_mac(frame, NET_HEADER_SIZE + hdr->len - AUTH_MAC_SIZE, &c[AUTH_COUNTER_SIZE]);
+}
+
+/* returns 1 if mac and counter are fine */
+uint8_t auth_check(uint8_t *frame)
+{
+	struct net_header *hdr = (struct net_header*)frame;
+	struct auth_node *n = 0, floor;
+	uint8_t mac[AUTH_MAC_SIZE], *c, i;
+	uint32_t counter;
+
+	if(hdr->len < AUTH_SIZE)
+		return 0;
+	c = &frame[NET_HEADER_SIZE + hdr->len - AUTH_SIZE];
+	auth_mac(frame, NET_HEADER_SIZE + hdr->len - AUTH_MAC_SIZE, mac);
+	if(memcmp(mac, &c[AUTH_COUNTER_SIZE], AUTH_MAC_SIZE))
+		return 0;
+
+	counter = ((uint32_t)c[0] << 24) | ((uint32_t)c[1] << 16) | ((uint16_t)c[2] << 8) | c[3];
+	for(i=0;i<AUTH_NODES && !n;i++)
+		if(nodes[i].node == hdr->src)
+			n = &nodes[i];
+	for(i=0;i<AUTH_NODES && !n;i++)
+		if(!nodes[i].node)
+		{
+			n = &nodes[i];
+			n->node = hdr->src;
+			n->counter = 0;
+		}
+	/* table full, taking one over would forget its floor */
+	if(!n || counter <= n->counter)
+		return 0;
+	n->counter = counter;
+
+	/* move the floor on once the counter leaves the block it covers,
+	 * only the bytes that changed are written */
+	eeprom_read_block(&floor, &ee_nodes[n - nodes], sizeof(floor));
+	if(floor.node != n->node || counter > floor.counter)
+	{
+		floor.node = n->node;
+		floor.counter = counter | (AUTH_FLOOR_STEP - 1);
+		eeprom_update_block(&floor, &ee_nodes[n - nodes], sizeof(floor));
+	}
+	return 1;
+}
+
+/* 10;44;bytes;us;cycles;cycle budget;airtime of the mac in us;airtime of the frame in us */
+void auth_bench(void)
+{
+	uint8_t frame[NET_HEADER_SIZE + NET_MAX_PAYLOAD], mac[AUTH_MAC_SIZE], i;
+	uint32_t us;
+
+	memset(frame, 0x55, sizeof(frame));
+	us = clock_us();
+	for(i=0;i<10;i++)
+		auth_mac(frame, sizeof(frame) - AUTH_MAC_SIZE, mac);
+	us = (clock_us() - us) / 10;
+	fprintf_P(telemetry,PSTR("10;44;%d;%lu;%lu;%lu;%lu;%lu\r\n"),NET_HEADER_SIZE + NET_MAX_PAYLOAD - AUTH_MAC_SIZE,us,
+		us * (F_CPU / 1000000UL),AUTH_CYCLE_BUDGET,
+		airtime_frame_us(sizeof(frame)) - airtime_frame_us(sizeof(frame) - AUTH_SIZE),
+		airtime_frame_us(sizeof(frame)));
+}
+
+#endif
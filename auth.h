@@ -0,0 +1,60 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_AUTH_H__
+#define __DEFINE_AUTH_H__
+
+/* Authenticated frames (NET_FLAG_AUTH)
+ *
+ * Behind the payload: counter (4 bytes, high first) | mac (4 bytes)
+ * The header len includes these 8 bytes.
+ *
+ * mac = first 4 bytes of an XTEA CBC-MAC over header, payload and
+ * counter, with ttl and hops taken as 0 so relays don't break it.
+ * Blocks are two little endian words as on the AVR, the last one is
+ * padded with zeros. A counter that isn't bigger than the last one of
+ * the same sender is a replay.
+ *
+ * The station's counter survives a reset, its upper half is kept in
+ * the eeprom. So do the senders' counters: the eeprom holds the end
+ * of the AUTH_FLOOR_STEP block the last accepted counter is in, after
+ * a reset everything up to there counts as seen. A sender that keeps
+ * its counter over the station's reset has up to AUTH_FLOOR_STEP frames
+ * refused. In return, with one frame a second, a sender's cell is
+ * written every 17 minutes, and its 100000 writes last three years.
+ * The table has room for AUTH_NODES senders and nobody is pushed out,
+ * frames from further senders fail with 10;43. COMMAND_SET_KEY sets
+ * the key and empties the table. */
+#define AUTH_COUNTER_SIZE	4
+#define AUTH_MAC_SIZE		4
+#define AUTH_SIZE			(AUTH_COUNTER_SIZE + AUTH_MAC_SIZE)
+#define AUTH_NODES			8		// senders with a replay counter
+#define AUTH_FLOOR_STEP		1024	// accepted counters per eeprom write
+#define AUTH_CYCLE_BUDGET	48000UL	// signing a full frame, 3ms at 16MHz
+//#define AUTH_REQUIRED				// drop everything that isn't signed
+
+extern void auth_init(void);
+extern void auth_set_key(uint8_t *key);
+extern void auth_sign(uint8_t *frame);
+extern uint8_t auth_check(uint8_t *frame);
+extern void auth_bench(void);
+
+#endif
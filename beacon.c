@@ -0,0 +1,71 @@
+/* Time synchronization beacons
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <avr/pgmspace.h>
+
+#include "main.h"
+#include "clock.h"
+#include "net.h"
+#include "txq.h"
+#include "beacon.h"
+
+static uint16_t interval;
+static uint32_t last;
+
+void beacon_init(void)
+{
+	interval = BEACON_INTERVAL;
+	last = clock_ms();
+}
+
+void beacon_config(uint16_t seconds)
+{
+	interval = seconds;
+	printf_P(PSTR("10;42;%u\r\n"),interval);
+}
+
+/* called by the tx queue for every frame just before it goes out */
+void beacon_stamp(uint8_t *frame, uint8_t len)
+{
+	struct net_header *hdr = (struct net_header*)frame;
+	uint32_t now;
+
+	if(len < NET_HEADER_SIZE + 4 || hdr->magic != NET_MAGIC ||
+		(hdr->type & NET_TYPE_MASK) != NET_TYPE_BEACON || hdr->src != MY_ADDRESS)
+		return;
+	now = clock_ms();
+	frame[NET_HEADER_SIZE] = now >> 24;
+	frame[NET_HEADER_SIZE + 1] = now >> 16;
+	frame[NET_HEADER_SIZE + 2] = now >> 8;
+	frame[NET_HEADER_SIZE + 3] = now;
+}
+
+void beacon_poll(void)
+{
+	uint8_t time[4] = {0, 0, 0, 0};
+
+	if(!interval || clock_ms() - last < interval * 1000UL)
+		return;
+	last = clock_ms();
+	net_frame(NET_TYPE_BEACON, NET_BROADCAST, NET_BROADCAST, time, sizeof(time), TXQ_HIGH);
+}
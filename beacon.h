@@ -0,0 +1,42 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_BEACON_H__
+#define __DEFINE_BEACON_H__
+
+/* Time beacons
+ *
+ * Once the host sets an interval (COMMAND_SET_BEACON), NET_TYPE_BEACON
+ * goes to everybody every few seconds and carries the station clock in ms (4 bytes, high byte first). The time is written
+ * into the frame right before it is handed to the rf12 lib, so time
+ * spent in the queue doesn't show up as offset on the nodes.
+ *
+ * Frames with NET_FLAG_AT start with the same kind of time stamp, the
+ * node executes them when its own idea of the station clock gets
+ * there. */
+#define BEACON_INTERVAL	0		// seconds, 0 = off until the host sets one
+
+extern void beacon_init(void);
+extern void beacon_config(uint16_t interval);
+extern void beacon_stamp(uint8_t *frame, uint8_t len);
+extern void beacon_poll(void);
+
+#endif
@@ -0,0 +1,144 @@
+/* Buzzer
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <string.h>
+
+#include "buzzer.h"
+
+static const uint8_t builtin[BUZZER_BUILTIN][BUZZER_STEPS] PROGMEM = {
+	{10, 20},
+	{10, 10, 10, 50},
+	{50, 50},
+	{3, 3, 3, 3, 3, 60}
+};
+
+static uint8_t uploaded[BUZZER_STEPS], uploaded_len;
+
+/* the pattern running, read by the clock */
+static uint8_t seq[BUZZER_STEPS];
+static volatile uint8_t seq_len;	// 0 = plain beep or nothing
+static uint8_t seq_step, seq_repeats;
+
+static volatile uint16_t beep_left;	// ms of the current step, 0 = silent
+
+static uint16_t buzzer_step_ms(uint8_t step)
+{
+	return step ? step * 10 : 1;
+}
+
+/* on or off for good, ends a beep */
+void buzzer_set(uint8_t on)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	beep_left = 0;
+	seq_len = 0;
+	if(on)
+		PORTD &= ~(1<<PD7);
+	else
+		PORTD |= (1<<PD7);
+	SREG = sreg;
+}
+
+void buzzer_beep(uint16_t ms)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	seq_len = 0;
+	PORTD &= ~(1<<PD7);
+	beep_left = ms;
+	SREG = sreg;
+}
+
+/* keeps steps as pattern 0, returns 0 if there are too many */
+uint8_t buzzer_pattern(uint8_t *steps, uint8_t len)
+{
+	if(!len || len > BUZZER_STEPS)
+		return 0;
+	memcpy(uploaded, steps, len);
+	uploaded_len = len;
+	return 1;
+}
+
+/* returns 0 for an unknown pattern */
+uint8_t buzzer_play(uint8_t pattern, uint8_t repeats)
+{
+	uint8_t buf[BUZZER_STEPS], len, sreg;
+
+	if(!pattern)
+	{
+		memcpy(buf, uploaded, sizeof(buf));
+		len = uploaded_len;
+	}
+	else if(pattern <= BUZZER_BUILTIN)
+	{
+		memcpy_P(buf, builtin[pattern - 1], sizeof(buf));
+		/* trailing zeros are unused steps */
+		for(len=BUZZER_STEPS;len && !buf[len-1];len--)
+			;
+	}
+	else
+		return 0;
+	if(!len)
+		return 0;
+
+	sreg = SREG;
+	cli();
+	memcpy(seq, buf, len);
+	seq_len = len;
+	seq_step = 0;
+	seq_repeats = repeats;
+	PORTD &= ~(1<<PD7);
+	beep_left = buzzer_step_ms(seq[0]);
+	SREG = sreg;
+	return 1;
+}
+
+/* from the 1kHz clock */
+void buzzer_tick(void)
+{
+	if(!beep_left || --beep_left)
+		return;
+	if(seq_len)
+	{
+		if(++seq_step == seq_len)
+		{
+			seq_step = 0;
+			if(seq_repeats && !--seq_repeats)
+				seq_len = 0;
+		}
+	}
+	if(!seq_len)
+	{
+		PORTD |= (1<<PD7);
+		return;
+	}
+	if(seq_step & 1)
+		PORTD |= (1<<PD7);
+	else
+		PORTD &= ~(1<<PD7);
+	beep_left = buzzer_step_ms(seq[seq_step]);
+}
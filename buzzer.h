@@ -0,0 +1,42 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_BUZZER_H__
+#define __DEFINE_BUZZER_H__
+
+/* Buzzer on PD7, active low
+ *
+ * A pattern is a list of durations in 10ms, on and off in turn,
+ * starting with on. The 1kHz clock plays it, the main loop is not
+ * involved. Pattern 0 is the one the host uploaded with
+ * COMMAND_BUZZER_PATTERN, 1 to BUZZER_BUILTIN are in flash. repeats = 0
+ * plays it until something else is played or the buzzer is switched.
+ * The host gets "10;58;ok" for an upload and "10;59;pattern;ok". */
+#define BUZZER_STEPS	8
+#define BUZZER_BUILTIN	4		// 1 beep, 2 double beep, 3 alarm, 4 chirp
+
+extern void buzzer_set(uint8_t on);
+extern void buzzer_beep(uint16_t ms);
+extern uint8_t buzzer_pattern(uint8_t *steps, uint8_t len);
+extern uint8_t buzzer_play(uint8_t pattern, uint8_t repeats);
+extern void buzzer_tick(void);
+
+#endif
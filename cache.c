@@ -0,0 +1,121 @@
+/* Last value cache of node readings
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "clock.h"
+#include "cache.h"
+
+struct cache_entry {
+	uint8_t node;	// 0 = unused
+	uint8_t sensor;
+	int16_t value;
+	uint32_t stamp;	// clock_ms() when it was received
+};
+
+static struct cache_entry cache[CACHE_ENTRIES];
+
+void cache_init(void)
+{
+	memset(cache, 0, sizeof(cache));
+}
+
+static uint16_t cache_age(struct cache_entry *e)
+{
+	uint32_t age = (clock_ms() - e->stamp) / 1000;
+
+	return age > 0xFFFF ? 0xFFFF : age;
+}
+
+static struct cache_entry *cache_find(uint8_t node, uint8_t sensor)
+{
+	uint8_t i;
+
+	for(i=0;i<CACHE_ENTRIES;i++)
+		if(cache[i].node == node && cache[i].sensor == sensor)
+			return &cache[i];
+	return 0;
+}
+
+static void cache_print(struct cache_entry *e)
+{
+	printf_P(PSTR("10;45;%d;%d;%d;%u\r\n"),e->node,e->sensor,e->value,cache_age(e));
+}
+
+/* payload of a NET_TYPE_READING frame from node */
+void cache_rx(uint8_t node, uint8_t *data, uint8_t len)
+{
+	struct cache_entry *e;
+	uint8_t i;
+
+	for(;len>=CACHE_RECORD;len-=CACHE_RECORD,data+=CACHE_RECORD)
+	{
+		e = cache_find(node, data[0]);
+		/* new one, take a free or the oldest entry */
+		if(!e)
+		{
+			for(i=0;i<CACHE_ENTRIES;i++)
+			{
+				if(!cache[i].node)
+				{
+					e = &cache[i];
+					break;
+				}
+				if(!e || (int32_t)(cache[i].stamp - e->stamp) < 0)
+					e = &cache[i];
+			}
+			e->node = node;
+			e->sensor = data[0];
+		}
+		e->value = (data[1] << 8) | data[2];
+		e->stamp = clock_ms();
+		cache_print(e);
+	}
+}
+
+/* "10;46;node;sensor" if there is nothing */
+void cache_get(uint8_t node, uint8_t sensor)
+{
+	struct cache_entry *e = cache_find(node, sensor);
+
+	if(e && node)
+		cache_print(e);
+	else
+		printf_P(PSTR("10;46;%d;%d\r\n"),node,sensor);
+}
+
+/* everything in one line: 10;47;count;node;sensor;value;age;... */
+void cache_dump(void)
+{
+	uint8_t i, count = 0;
+
+	for(i=0;i<CACHE_ENTRIES;i++)
+		if(cache[i].node)
+			count++;
+	printf_P(PSTR("10;47;%d"),count);
+	for(i=0;i<CACHE_ENTRIES;i++)
+		if(cache[i].node)
+			printf_P(PSTR(";%d;%d;%d;%u"),cache[i].node,cache[i].sensor,cache[i].value,cache_age(&cache[i]));
+	printf_P(PSTR("\r\n"));
+}
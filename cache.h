@@ -0,0 +1,42 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_CACHE_H__
+#define __DEFINE_CACHE_H__
+
+/* Last value cache
+ *
+ * Nodes report readings with NET_TYPE_READING, the payload is
+ * sensor | value (high, low) for one or more sensors. The station
+ * keeps the latest value of every (node, sensor) and answers the host
+ * from here, without waking up the node.
+ *
+ * Every reading, fresh or from the cache, goes to the host as
+ * "10;45;node;sensor;value;age in s". */
+#define CACHE_ENTRIES	8
+#define CACHE_RECORD	3		// sensor, value high, value low
+
+extern void cache_init(void);
+extern void cache_rx(uint8_t node, uint8_t *data, uint8_t len);
+extern void cache_get(uint8_t node, uint8_t sensor);
+extern void cache_dump(void);
+
+#endif
@@ -0,0 +1,91 @@
+/* Millisecond timebase
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "clock.h"
+#include "cut.h"
+#include "lcd.h"
+#include "relay.h"
+#include "buzzer.h"
+#include "counter.h"
+
+/* timer2 of the parts with two usarts (atmega324p) */
+#ifdef TIMSK2
+#define OCR2	OCR2A
+#define OCF2	OCF2A
+#define TIMER2_COMP_vect	TIMER2_COMPA_vect
+#else
+#define TIFR2	TIFR
+#endif
+
+static volatile uint32_t millis;
+
+void clock_init(void)
+{
+	/* CTC, prescaler 64, 16MHz/64/250 = 1kHz */
+	OCR2 = F_CPU/64/CLOCK_HZ - 1;
+#ifdef TIMSK2
+	TCCR2A = (1<<WGM21);
+	TCCR2B = (1<<CS22);
+	TIMSK2 |= (1<<OCIE2A);
+#else
+	TCCR2 = (1<<WGM21) | (1<<CS22);
+	TIMSK |= (1<<OCIE2);
+#endif
+}
+
+uint32_t clock_ms(void)
+{
+	uint32_t ms;
+	uint8_t sreg = SREG;
+
+	cli();
+	ms = millis;
+	SREG = sreg;
+	return ms;
+}
+
+/* 4us resolution, for benchmarks */
+uint32_t clock_us(void)
+{
+	uint32_t ms;
+	uint8_t t, sreg = SREG;
+
+	cli();
+	ms = millis;
+	t = TCNT2;
+	/* compare match already happened but the ISR hasn't run yet */
+	if((TIFR2 & (1<<OCF2)) && t < OCR2/2)
+		ms++;
+	SREG = sreg;
+	return ms * 1000 + t * (64000000UL / F_CPU);
+}
+
+ISR(TIMER2_COMP_vect)
+{
+	millis++;
+	cut_tick();
+	lcd_tick();
+	relay_tick();
+	buzzer_tick();
+	counter_tick();
+}
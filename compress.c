@@ -0,0 +1,334 @@
+/* Dictionary and delta compression for RF payloads
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "global.h"
+#include "uart.h"
+#include "main.h"
+#include "clock.h"
+#include "net.h"
+#include "compress.h"
+#include "auth.h"
+#include "tag.h"
+#include "telemetry.h"
+
+#ifdef USE_COMPRESSION
+
+/* text that shows up on our lcds again and again, longest match wins */
+#define DICT_WIDTH 8
+static const char dict[][DICT_WIDTH] PROGMEM = {
+	"        ", "    ", "  ", "Temperat", "ur", "\xDF" "C", "Feuchte", "Licht",
+	"Relais", "Status", "Fenster", "Heizung", "Wohnzimm", "Kueche", "Schlafzi", "Garage",
+	"Tuer", "offen", "zu", "An", "Aus", "ein", "aus", "on",
+	"off", "OK", "Fehler", "Error", "Batterie", "Hallo", "Welt", "Uhr",
+	":00", "0.", ".0", "00", " %", "er", "en", "ch",
+	"ie", "ei", "st", "te", "ng", "in", "de", "un",
+	"th", "he", "the ", "and ", "ing", "Innen", "Aussen", "Wasser"
+};
+#define DICT_ENTRIES (sizeof(dict) / DICT_WIDTH)
+
+struct comp_base {
+	uint8_t node;
+	uint8_t used;
+	uint8_t id;			// seq of the frame the base came from
+	uint8_t deltas;		// deltas sent on top of it
+	uint8_t len;
+	uint8_t data[COMP_BASE_SIZE];
+};
+
+struct comp_stats {
+	uint32_t raw;		// bytes before compression
+	uint32_t packed;	// bytes after compression
+	uint32_t us;		// time spent
+};
+
+static struct comp_base tx_base[COMP_NODES], rx_base[COMP_NODES];
+static uint8_t tx_victim, rx_victim;
+static struct comp_stats enc, dec;
+static uint8_t out[NET_MAX_PAYLOAD], tmp[NET_MAX_PAYLOAD];
+
+void comp_init(void)
+{
+	memset(tx_base, 0, sizeof(tx_base));
+	memset(rx_base, 0, sizeof(rx_base));
+	memset(&enc, 0, sizeof(enc));
+	memset(&dec, 0, sizeof(dec));
+}
+
+static struct comp_base *comp_base(struct comp_base *table, uint8_t *victim, uint8_t node)
+{
+	uint8_t i;
+	struct comp_base *b;
+
+	for(i=0;i<COMP_NODES;i++)
+		if(table[i].used && table[i].node == node)
+			return &table[i];
+	b = &table[*victim];
+	if(++*victim == COMP_NODES)
+		*victim = 0;
+	b->node = node;
+	b->used = 0;
+	return b;
+}
+
+static void comp_base_set(struct comp_base *b, uint8_t id, uint8_t *data, uint8_t len)
+{
+	b->used = len <= COMP_BASE_SIZE;
+	b->id = id;
+	b->len = len;
+	if(b->used)
+		memcpy(b->data, data, len);
+}
+
+/* returns the encoded length, 0 if it doesn't fit into max */
+static uint8_t dict_encode(uint8_t *in, uint8_t len, uint8_t *o, uint8_t max)
+{
+	uint8_t i = 0, n = 0, e, k, c, best = 0, best_len;
+
+	while(i < len)
+	{
+		best_len = 1;
+		for(e=0;e<DICT_ENTRIES;e++)
+		{
+			if(pgm_read_byte(&dict[e][0]) != in[i])
+				continue;
+			for(k=1;k<DICT_WIDTH && i+k<len;k++)
+			{
+				c = pgm_read_byte(&dict[e][k]);
+				if(!c || c != in[i+k])
+					break;
+			}
+			/* only whole entries count */
+			if(k > best_len && (k == DICT_WIDTH || !pgm_read_byte(&dict[e][k])))
+			{
+				best = e;
+				best_len = k;
+			}
+		}
+		if(n + 2 > max)
+			return 0;
+		if(best_len > 1)
+		{
+			o[n++] = 0x80 | best;
+			i += best_len;
+			continue;
+		}
+		if(in[i] & 0x80)
+			o[n++] = 0xFF;
+		o[n++] = in[i++];
+	}
+	return n;
+}
+
+/* returns the encoded length, 0 if it doesn't fit into max */
+static uint8_t delta_encode(struct comp_base *b, uint8_t *in, uint8_t len, uint8_t *o, uint8_t max)
+{
+	uint8_t i = 0, n = 0, k;
+
+	while(i < len)
+	{
+		for(k=0;i+k<len && i+k<b->len && in[i+k] == b->data[i+k] && k<127;k++);
+		if(k)
+		{
+			if(n + 1 > max)
+				return 0;
+			o[n++] = 0x80 | k;
+			i += k;
+			continue;
+		}
+		for(k=0;i+k<len && !(i+k<b->len && in[i+k] == b->data[i+k]) && k<127;k++);
+		if(n + 1 + k > max)
+			return 0;
+		o[n++] = k;
+		memcpy(&o[n], &in[i], k);
+		n += k;
+		i += k;
+	}
+	return n;
+}
+
+/* picks the shortest of raw, dictionary and delta, flags are more
+ * NET_FLAG_s for the frame */
+void comp_send(uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio, uint8_t flags)
+{
+	struct comp_base *b = comp_base(tx_base, &tx_victim, dst);
+	uint32_t start = clock_us();
+	uint8_t n, size = len + 1, seq, max = NET_MAX_PAYLOAD;
+
+#ifdef USE_AUTH
+	if(flags & NET_FLAG_AUTH)
+		max -= AUTH_SIZE;
+#endif
+	if(len >= max)
+	{
+		if(flags)
+			net_send_type(NET_TYPE_DATA | flags, dst, data, len, prio);
+		else
+			net_send(dst, data, len, prio);
+		return;
+	}
+
+	out[0] = COMP_RAW;
+	memcpy(&out[1], data, len);
+
+	n = len > 2 ? dict_encode(data, len, &tmp[1], size - 2) : 0;
+	if(n)
+	{
+		tmp[0] = COMP_DICT;
+		size = n + 1;
+		memcpy(out, tmp, size);
+	}
+	if(b->used && b->deltas < COMP_REFRESH && len <= COMP_BASE_SIZE && size > 4)
+	{
+		n = delta_encode(b, data, len, &tmp[3], size - 4);
+		if(n)
+		{
+			tmp[0] = COMP_DELTA;
+			tmp[1] = b->id;
+			tmp[2] = len;
+			size = n + 3;
+			memcpy(out, tmp, size);
+		}
+	}
+	enc.us += clock_us() - start;
+	enc.raw += len;
+	enc.packed += size;
+
+	seq = net_send_type(NET_TYPE_DATA | NET_FLAG_COMPRESSED | flags, dst, out, size, prio);
+	/* the node never sees it, the base stays */
+	if(!seq)
+		return;
+	n = (out[0] == COMP_DELTA) ? b->deltas + 1 : 0;
+	comp_base_set(b, seq, data, len);
+	b->deltas = n;
+}
+
+/* unpacks a frame from src and hands it to the uart */
+void comp_rx(uint8_t src, uint8_t seq, uint8_t *data, uint8_t len)
+{
+	struct comp_base *b = comp_base(rx_base, &rx_victim, src);
+	uint32_t start = clock_us();
+	uint8_t i, k, n = 0, e, c;
+
+	if(!len)
+		return;
+	switch(data[0])
+	{
+		case COMP_RAW:
+			tag_line();
+			for(i=1;i<len;i++)
+				uart_putc(data[i]);
+			comp_base_set(b, seq, &data[1], len - 1);
+			n = len - 1;
+			break;
+		case COMP_DICT:
+			tag_line();
+			/* only the first COMP_BASE_SIZE bytes are needed as base */
+			for(i=1;i<len;i++)
+			{
+				if(data[i] == 0xFF && i + 1 < len)
+				{
+					c = data[++i];
+					if(n < COMP_BASE_SIZE)
+						tmp[n] = c;
+					n++;
+					uart_putc(c);
+				}
+				else if(data[i] & 0x80)
+				{
+					e = data[i] & 0x7F;
+					if(e >= DICT_ENTRIES)
+						break;
+					for(k=0;k<DICT_WIDTH && (c = pgm_read_byte(&dict[e][k]));k++)
+					{
+						if(n < COMP_BASE_SIZE)
+							tmp[n] = c;
+						n++;
+						uart_putc(c);
+					}
+				}
+				else
+				{
+					if(n < COMP_BASE_SIZE)
+						tmp[n] = data[i];
+					n++;
+					uart_putc(data[i]);
+				}
+			}
+			if(n <= COMP_BASE_SIZE)
+				comp_base_set(b, seq, tmp, n);
+			else
+				b->used = 0;
+			break;
+		case COMP_DELTA:
+			if(len < 3 || !b->used || b->id != data[1] || data[2] > COMP_BASE_SIZE)
+			{
+				/* base is gone or stale, wait for the next full frame */
+				printf_P(PSTR("10;27;%d\r\n"),src);
+				return;
+			}
+			for(i=3;i<len && n<data[2];)
+			{
+				k = data[i] & 0x7F;
+				if(data[i++] & 0x80)
+				{
+					for(;k && n<data[2] && n<b->len;k--,n++)
+						tmp[n] = b->data[n];
+				}
+				else
+				{
+					for(;k && i<len && n<data[2];k--,n++)
+						tmp[n] = data[i++];
+				}
+			}
+			tag_line();
+			for(i=0;i<n;i++)
+				uart_putc(tmp[i]);
+			comp_base_set(b, seq, tmp, n);
+			break;
+		default:
+			return;
+	}
+	dec.us += clock_us() - start;
+	dec.packed += len;
+	dec.raw += n;
+}
+
+static uint16_t comp_cycles(struct comp_stats *s)
+{
+	if(!s->raw)
+		return 0;
+	return s->us * (F_CPU / 1000000UL) / s->raw;
+}
+
+/* 10;26;raw bytes;compressed bytes;size in %;encode cycles/byte;decode cycles/byte */
+void comp_report(void)
+{
+	fprintf_P(telemetry,PSTR("10;26;%lu;%lu;%lu;%u;%u\r\n"),enc.raw,enc.packed,
+		enc.raw ? enc.packed * 100 / enc.raw : 100,
+		comp_cycles(&enc),comp_cycles(&dec));
+}
+
+#endif
@@ -0,0 +1,50 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_COMPRESS_H__
+#define __DEFINE_COMPRESS_H__
+
+/* Payload compression for framed RF traffic (NET_FLAG_COMPRESSED)
+ *
+ * First payload byte is the method:
+ * COMP_RAW   data as is
+ * COMP_DICT  bytes < 0x80 literal, 0x80+n entry n of the text
+ *            dictionary, 0xFF escapes a literal byte >= 0x80
+ * COMP_DELTA base id, length, then runs against the last payload of
+ *            the node: 0x80+n n unchanged bytes, n followed by n new ones
+ *
+ * Every frame up to COMP_BASE_SIZE bytes becomes the new base for the
+ * next delta on both sides. A receiver whose base id doesn't match
+ * drops the frame, after COMP_REFRESH deltas a full frame is sent. */
+#define COMP_RAW		0
+#define COMP_DICT		1
+#define COMP_DELTA		2
+
+#define COMP_NODES		4		// nodes with a delta base in each direction
+#define COMP_BASE_SIZE	16		// longest payload kept as delta base
+#define COMP_REFRESH	8		// deltas in a row before a full frame
+
+extern void comp_init(void);
+extern void comp_send(uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio, uint8_t flags);
+extern void comp_rx(uint8_t src, uint8_t seq, uint8_t *data, uint8_t len);
+extern void comp_report(void);
+
+#endif
@@ -0,0 +1,258 @@
+/* Station configuration
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+#include <stdio.h>
+#include <avr/pgmspace.h>
+
+#include "main.h"
+#include "net.h"
+#include "uart.h"
+#include "group.h"
+#include "mailbox.h"
+#include "airtime.h"
+#include "config.h"
+
+/* tables of other modules that are kept in every slot, in this order */
+struct config_table {
+	void *ram;
+	uint8_t size;
+};
+
+static const struct config_table tables[] PROGMEM = {
+	{net_routes, sizeof(net_routes)},
+	{groups, sizeof(groups)},
+	{mailbox_setup, sizeof(mailbox_setup)},
+	{&airtime_limits, sizeof(airtime_limits)},
+};
+#define CONFIG_TABLES	(sizeof(tables) / sizeof(tables[0]))
+#define CONFIG_TABLE_BYTES	(sizeof(net_routes) + sizeof(groups) + \
+	sizeof(mailbox_setup) + sizeof(airtime_limits))
+
+/* the head comes last, its crc is the last byte written */
+struct config_slot {
+	uint8_t tables[CONFIG_TABLE_BYTES];
+	struct config head;
+};
+
+static struct config_slot ee_slots[CONFIG_SLOTS] EEMEM;
+static struct config cfg;
+static uint8_t slot;			// slot cfg was read from or is written to
+static uint8_t writing;			// 1 while config_poll() writes the slot
+static uint8_t pos;				// next byte of it
+unsigned char myAddress;
+
+/* byte n of the slot as it is in ram right now */
+static uint8_t config_byte(uint8_t n)
+{
+	uint8_t i, size;
+
+	for(i=0;i<CONFIG_TABLES;i++)
+	{
+		size = pgm_read_byte(&tables[i].size);
+		if(n < size)
+			return ((uint8_t*)pgm_read_word(&tables[i].ram))[n];
+		n -= size;
+	}
+	return ((uint8_t*)&cfg)[n];
+}
+
+static uint16_t config_crc(void)
+{
+	uint16_t crc = 0xFFFF;
+	uint8_t i;
+
+	for(i=0;i<sizeof(struct config_slot)-sizeof(cfg.crc);i++)
+		crc = _crc_ccitt_update(crc, config_byte(i));
+	return crc;
+}
+
+/* same as config_crc() over what slot i holds in the eeprom */
+static uint16_t config_crc_slot(uint8_t i)
+{
+	uint8_t *p = (uint8_t*)&ee_slots[i];
+	uint16_t crc = 0xFFFF;
+	uint8_t n;
+
+	for(n=0;n<sizeof(struct config_slot)-sizeof(cfg.crc);n++)
+		crc = _crc_ccitt_update(crc, eeprom_read_byte(&p[n]));
+	return crc;
+}
+
+static void config_defaults(void)
+{
+	cfg.version = CONFIG_VERSION;
+	cfg.address = MY_ADDRESS_DEFAULT;
+	cfg.channel = CHANNEL;
+	cfg.rf_rate = RF_BAUDRATE;
+	cfg.uart_rate = UART_BAUDRATE;
+}
+
+/* one pass over the slots, ~450 bytes read. Has to come before the
+ * init of the modules whose tables it loads. */
+void config_init(void)
+{
+	struct config c;
+	uint8_t i, found = 0, *p;
+
+	for(i=0;i<CONFIG_SLOTS;i++)
+	{
+		eeprom_read_block(&c, &ee_slots[i].head, sizeof(c));
+		if(c.version != CONFIG_VERSION || c.crc != config_crc_slot(i))
+			continue;
+		/* seq wraps, only the distance counts */
+		if(!found || (int16_t)(c.seq - cfg.seq) > 0)
+		{
+			cfg = c;
+			slot = i;
+			found = 1;
+		}
+	}
+	if(!found)
+	{
+		config_defaults();
+		cfg.seq = 0;
+		slot = CONFIG_SLOTS - 1;
+	}
+	else
+	{
+		/* without a slot the tables keep their compiled defaults */
+		p = ee_slots[slot].tables;
+		for(i=0;i<CONFIG_TABLES;i++)
+		{
+			eeprom_read_block((void*)pgm_read_word(&tables[i].ram), p,
+				pgm_read_byte(&tables[i].size));
+			p += pgm_read_byte(&tables[i].size);
+		}
+	}
+	myAddress = cfg.address;
+}
+
+uint32_t config_get(uint8_t key)
+{
+	switch(key)
+	{
+		case CONFIG_ADDRESS:	return cfg.address;
+		case CONFIG_CHANNEL:	return cfg.channel;
+		case CONFIG_RF_RATE:	return cfg.rf_rate;
+		case CONFIG_UART_RATE:	return cfg.uart_rate;
+	}
+	return 0;
+}
+
+/* something in cfg or the tables changed. It goes to the next slot of
+ * the ring, the old one stays valid until that is done. A change while
+ * the slot is being written starts it over. */
+void config_save(void)
+{
+	if(!writing)
+	{
+		if(++slot == CONFIG_SLOTS)
+			slot = 0;
+		cfg.seq++;
+		writing = 1;
+	}
+	cfg.crc = config_crc();
+	pos = 0;
+}
+
+/* one byte per call, a write takes ~3.4ms and the main loop mustn't
+ * wait for 110 of them */
+void config_poll(void)
+{
+	if(!writing || !eeprom_is_ready())
+		return;
+	eeprom_update_byte(&((uint8_t*)&ee_slots[slot])[pos], config_byte(pos));
+	if(++pos == sizeof(struct config_slot))
+		writing = 0;
+}
+
+static const uint32_t uart_rates[] PROGMEM = {
+	1200, 2400, 4800, 9600, 14400, 19200, 28800, 38400, 57600, 76800,
+	115200, 230400, 250000, 500000, 1000000
+};
+
+/* a standard rate the uart divider gets within 2% of, anything else
+ * would leave the host unable to talk to the station after a reset */
+static uint8_t config_uart_rate(uint32_t rate)
+{
+	uint32_t real;
+	uint8_t i;
+
+	if(rate > F_CPU / 16)
+		return 0;
+	for(i=0;i<sizeof(uart_rates)/sizeof(uart_rates[0]);i++)
+		if(pgm_read_dword(&uart_rates[i]) == rate)
+		{
+			real = F_CPU / (16UL * (UART_BAUD_SELECT(rate, F_CPU) + 1));
+			return (real > rate ? real - rate : rate - real) * 50 <= rate;
+		}
+	return 0;
+}
+
+/* returns 0 for an unknown key or a value out of range */
+uint8_t config_set(uint8_t key, uint32_t value)
+{
+	struct config old = cfg;
+
+	switch(key)
+	{
+		case CONFIG_ADDRESS:
+			if(!value || value >= NET_GROUP_FIRST)
+				return 0;
+			cfg.address = value;
+			break;
+		case CONFIG_CHANNEL:
+			if(value > 3)
+				return 0;
+			cfg.channel = value;
+			break;
+		case CONFIG_RF_RATE:
+			if(value < 1000 || value > 0xFFFF)
+				return 0;
+			cfg.rf_rate = value;
+			break;
+		case CONFIG_UART_RATE:
+			if(!config_uart_rate(value))
+				return 0;
+			cfg.uart_rate = value;
+			break;
+		case CONFIG_DEFAULTS:
+			config_defaults();
+			break;
+		default:
+			return 0;
+	}
+	/* nothing changed, spare the eeprom */
+	if(old.address == cfg.address && old.channel == cfg.channel &&
+		old.rf_rate == cfg.rf_rate && old.uart_rate == cfg.uart_rate)
+		return 1;
+	config_save();
+	myAddress = cfg.address;
+	return 1;
+}
+
+void config_report(uint8_t key)
+{
+	printf_P(PSTR("10;60;%d;%lu\r\n"),key,config_get(key));
+}
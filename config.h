@@ -0,0 +1,73 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_CONFIG_H__
+#define __DEFINE_CONFIG_H__
+
+/* Station configuration in the eeprom
+ *
+ * Every change appends the whole block to a ring of CONFIG_SLOTS, so
+ * each eeprom cell is written only every CONFIG_SLOTS changes. The
+ * slot with a good crc and the newest sequence number wins at boot.
+ * Without one (new chip, other CONFIG_VERSION) the compiled defaults
+ * from main.h are used.
+ *
+ * Besides the keys below a slot holds the routes, groups, mailbox
+ * settings and airtime limits, the commands that set those call
+ * config_save() and read them back as before. config_poll() writes
+ * the slot a byte at a time from the main loop, about 0.4s for the
+ * 110 bytes, so the uart isn't held up meanwhile.
+ *
+ * COMMAND_GET_CONFIG / COMMAND_SET_CONFIG answer "10;60;key;value",
+ * a refused key or value gives "10;61;key".
+ * Address, channel and rf rate are used at once, the uart rate after
+ * the next reset. The uart rate has to be a standard one (1200 to
+ * 1000000) the divider gets within 2% of at F_CPU, at 16MHz that
+ * rules out 57600, 115200 and 230400. Key CONFIG_DEFAULTS sets the keys
+ * back to the defaults, the tables stay. */
+#define CONFIG_VERSION	2
+#define CONFIG_SLOTS	4
+
+#define CONFIG_ADDRESS	0
+#define CONFIG_CHANNEL	1
+#define CONFIG_RF_RATE	2
+#define CONFIG_UART_RATE	3
+#define CONFIG_KEYS		4
+#define CONFIG_DEFAULTS	0xFF
+
+struct config {
+	uint8_t version;
+	uint8_t address;
+	uint8_t channel;
+	uint16_t rf_rate;
+	uint32_t uart_rate;
+	uint16_t seq;		// newer slots have a higher one
+	uint16_t crc;		// of everything above
+};
+
+extern void config_init(void);
+extern uint32_t config_get(uint8_t key);
+extern uint8_t config_set(uint8_t key, uint32_t value);
+extern void config_report(uint8_t key);
+extern void config_save(void);
+extern void config_poll(void);
+
+#endif
@@ -0,0 +1,106 @@
+/* Pulse counters
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <avr/pgmspace.h>
+
+#include "clock.h"
+#include "counter.h"
+
+static volatile uint32_t counts[COUNTER_INPUTS];
+static volatile uint8_t stable;		// debounced pin levels, PIND bit positions
+static uint8_t held[COUNTER_INPUTS];	// ms the pin differs from stable
+static volatile uint8_t width = COUNTER_WIDTH;
+static uint16_t interval;			// s, 0 = per-edge lines
+static uint32_t last;
+
+void counter_init(void)
+{
+	stable = (PIND & COUNTER_MASK) | COUNTER_OPEN;
+}
+
+void counter_config(uint8_t w, uint16_t s)
+{
+	width = w ? w : 1;
+	interval = s;
+	counter_report();
+}
+
+/* debounced PD3-PD6, same bits as PIND */
+uint8_t counter_inputs(void)
+{
+	return stable;
+}
+
+/* 1 if every edge is reported on its own */
+uint8_t counter_edges(void)
+{
+	return !interval;
+}
+
+/* all counters at the same moment */
+void counter_read(uint32_t *c)
+{
+	uint8_t i, sreg = SREG;
+
+	cli();
+	for(i=0;i<COUNTER_INPUTS;i++)
+		c[i] = counts[i];
+	SREG = sreg;
+}
+
+void counter_report(void)
+{
+	uint32_t c[COUNTER_INPUTS];
+
+	counter_read(c);
+	printf_P(PSTR("10;57;%lu;%lu;%lu;%lu\r\n"),c[0],c[1],c[2],c[3]);
+	last = clock_ms();
+}
+
+void counter_poll(void)
+{
+	if(interval && clock_ms() - last >= interval * 1000UL)
+		counter_report();
+}
+
+/* from the 1kHz clock */
+void counter_tick(void)
+{
+	uint8_t now = (PIND & COUNTER_MASK) | COUNTER_OPEN;
+	uint8_t changed = now ^ stable;
+	uint8_t i, bit = (1<<PD3);
+
+	for(i=0;i<COUNTER_INPUTS;i++,bit<<=1)
+	{
+		if(!(changed & bit))
+			held[i] = 0;
+		else if(++held[i] >= width)
+		{
+			held[i] = 0;
+			stable ^= bit;
+			if(!(now & bit))
+				counts[i]++;
+		}
+	}
+}
@@ -0,0 +1,56 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_COUNTER_H__
+#define __DEFINE_COUNTER_H__
+
+/* Pulse counters on the digital inputs PD3-PD6
+ *
+ * The 1kHz clock samples the pins. A new level counts only after it
+ * held for the minimum width (COMMAND_SET_COUNTER), shorter spikes and
+ * contact bounce are dropped. Every close (S0 outputs pull the input
+ * to ground) adds one to the 32 bit counter of that input.
+ *
+ * COMMAND_GET_COUNTERS answers "10;57;c0;c1;c2;c3". With an interval
+ * set the same line comes every interval seconds by itself and the
+ * per-edge lines 10;30-37 are left out. */
+#define COUNTER_INPUTS	4
+#ifdef UDR1
+/* PD3 is TXD1 on the two usart parts, input 0 always reads open
+ * and never counts there */
+#define COUNTER_MASK	((1<<PD4)|(1<<PD5)|(1<<PD6))
+#define COUNTER_OPEN	(1<<PD3)
+#else
+#define COUNTER_MASK	((1<<PD3)|(1<<PD4)|(1<<PD5)|(1<<PD6))
+#define COUNTER_OPEN	0
+#endif
+#define COUNTER_WIDTH	20		// ms, default minimum pulse width
+
+extern void counter_init(void);
+extern void counter_config(uint8_t width, uint16_t interval);
+extern uint8_t counter_inputs(void);
+extern uint8_t counter_edges(void);
+extern void counter_read(uint32_t *c);
+extern void counter_report(void);
+extern void counter_poll(void);
+extern void counter_tick(void);
+
+#endif
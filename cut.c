@@ -0,0 +1,94 @@
+/* Cut-through RF to uart forwarding
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <avr/pgmspace.h>
+
+#include "rf12.h"
+#include "uart.h"
+#include "clock.h"
+#include "cut.h"
+#include "telemetry.h"
+
+static volatile uint8_t enabled;
+static uint32_t loop_look, isr_look;	// last look at rf12_data()
+static uint32_t loop_worst;
+static volatile uint32_t isr_worst;
+
+void cut_config(uint8_t on)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	enabled = on;
+	isr_look = clock_us();
+	SREG = sreg;
+	printf_P(PSTR("10;52;%d\r\n"),on);
+}
+
+uint8_t cut_active(void)
+{
+	return enabled;
+}
+
+/* main loop looked at rf12_data(), forwarded = 1 if it took a byte */
+void cut_loop(uint8_t forwarded)
+{
+	uint32_t now = clock_us();
+
+	if(forwarded && now - loop_look > loop_worst)
+		loop_worst = now - loop_look;
+	loop_look = now;
+}
+
+/* from the clock interrupt, uart_putc() must not wait in here */
+void cut_tick(void)
+{
+	uint32_t now;
+	uint8_t forwarded = 0;
+
+	if(!enabled)
+		return;
+	while(rf12_data() && uart_tx_free())
+	{
+		uart_putc(rf12_getchar());
+		forwarded = 1;
+	}
+	now = clock_us();
+	if(forwarded && now - isr_look > isr_worst)
+		isr_worst = now - isr_look;
+	isr_look = now;
+}
+
+void cut_report(void)
+{
+	uint32_t isr;
+	uint8_t sreg = SREG;
+
+	cli();
+	isr = isr_worst;
+	isr_worst = 0;
+	SREG = sreg;
+	fprintf_P(telemetry,PSTR("10;53;%lu;%lu\r\n"),loop_worst,isr);
+	loop_worst = 0;
+}
@@ -0,0 +1,44 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_CUT_H__
+#define __DEFINE_CUT_H__
+
+/* Cut-through forwarding
+ *
+ * The rf12 lib keeps its receive interrupt to itself, so with
+ * COMMAND_SET_CUT on the 1kHz clock interrupt takes the bytes out of
+ * the lib and puts them straight into the uart ring. Latency is then
+ * at most one clock tick plus the copying, whatever the main loop is
+ * doing. The network layer (relaying, acks, caches) and the sniffer
+ * don't see the bytes in this mode.
+ *
+ * Both paths keep the worst time from a look at rf12_data() to a byte
+ * being in the uart ring, COMMAND_GET_LATENCY reports and resets it:
+ * "10;53;main loop us;interrupt us". */
+
+extern void cut_config(uint8_t on);
+extern uint8_t cut_active(void);
+extern void cut_loop(uint8_t forwarded);
+extern void cut_tick(void);
+extern void cut_report(void);
+
+#endif
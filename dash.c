@@ -0,0 +1,153 @@
+/* LCD dashboard templates
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdio.h>
+
+#include "lcd.h"
+#include "clock.h"
+#include "net.h"
+#include "pool.h"
+#include "txq.h"
+#include "dash.h"
+#include "counter.h"
+
+struct dash_field {
+	uint8_t source;
+	uint8_t cell;		// 0-31
+	uint8_t width;
+};
+
+struct dash_template {
+	char text[33];
+	struct dash_field fields[DASH_FIELDS];
+};
+
+static const struct dash_template templates[] PROGMEM = {
+	{	/* 1: inputs and outputs */
+		"Relais          Inputs          ",
+		{{DASH_RELAIS, 8, 8}, {DASH_INPUTS, 28, 4}, {DASH_NONE}, {DASH_NONE}}
+	},
+	{	/* 2: link */
+		"rx       tx     pool     up    m",
+		{{DASH_RX, 3, 5}, {DASH_TX, 11, 5}, {DASH_POOL, 21, 3}, {DASH_UPTIME, 27, 4}}
+	},
+};
+#define DASH_TEMPLATES (sizeof(templates) / sizeof(templates[0]))
+
+static uint8_t current;			// 0 = off
+static uint16_t interval;
+static uint32_t last;
+static uint16_t shown[DASH_FIELDS];
+
+static uint16_t dash_value(uint8_t source)
+{
+	switch(source)
+	{
+		case DASH_RELAIS:	return PORTC;
+		case DASH_INPUTS:	return counter_inputs() >> 3;
+		case DASH_UPTIME:	return clock_ms() / 60000;
+		case DASH_RX:		return net_received;
+		case DASH_TX:		return txq_sent();
+		case DASH_POOL:		return pool_available();
+	}
+	return 0;
+}
+
+/* right aligned, bit fields msb first */
+static void dash_format(uint8_t source, uint16_t value, char *buf, uint8_t width)
+{
+	uint8_t i;
+
+	for(i=width;i--;)
+	{
+		if(source == DASH_RELAIS || source == DASH_INPUTS)
+		{
+			buf[i] = '0' + (value & 1);
+			value >>= 1;
+		}
+		else
+		{
+			buf[i] = (value || i == width - 1) ? '0' + value % 10 : ' ';
+			value /= 10;
+		}
+	}
+}
+
+static void dash_draw(uint8_t force)
+{
+	const struct dash_template *t = &templates[current - 1];
+	char buf[16];
+	uint8_t i, source, cell, width;
+	uint16_t value;
+
+	for(i=0;i<DASH_FIELDS;i++)
+	{
+		source = pgm_read_byte(&t->fields[i].source);
+		if(source == DASH_NONE)
+			break;
+		value = dash_value(source);
+		if(!force && value == shown[i])
+			continue;
+		shown[i] = value;
+		cell = pgm_read_byte(&t->fields[i].cell);
+		width = pgm_read_byte(&t->fields[i].width);
+		dash_format(source, value, buf, width);
+		lcd_field(cell >> 4, cell & 15, width, buf, width);
+	}
+}
+
+void dash_config(uint8_t template, uint16_t ms)
+{
+	char line[16];
+	uint8_t row, i;
+
+	if(template > DASH_TEMPLATES)
+		template = 0;
+	current = template;
+	interval = ms ? ms : DASH_INTERVAL;
+	printf_P(PSTR("10;54;%d;%u\r\n"),current,interval);
+	if(!current)
+		return;
+	for(row=0;row<2;row++)
+	{
+		for(i=0;i<16;i++)
+			line[i] = pgm_read_byte(&templates[current - 1].text[row * 16 + i]);
+		lcd_field(row, 0, 16, line, 16);
+	}
+	dash_draw(1);
+	last = clock_ms();
+}
+
+/* template shown, 0 = the host has the LCD */
+uint8_t dash_active(void)
+{
+	return current;
+}
+
+void dash_poll(void)
+{
+	if(!current || clock_ms() - last < interval)
+		return;
+	last = clock_ms();
+	dash_draw(0);
+}
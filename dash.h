@@ -0,0 +1,48 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_DASH_H__
+#define __DEFINE_DASH_H__
+
+/* LCD dashboards
+ *
+ * A template is fixed text in flash plus fields bound to station
+ * values. COMMAND_SET_DASH selects one (0 gives the LCD back to the
+ * host) and how often the fields are looked at. Only fields whose
+ * value changed are formatted again, and lcd_tick() only sends the
+ * cells that changed. */
+#define DASH_FIELDS		4		// per template
+#define DASH_INTERVAL	500		// ms
+
+/* where a field takes its value from */
+#define DASH_RELAIS		0		// PORTC, one digit per relay
+#define DASH_INPUTS		1		// PD3-PD6, one digit per input
+#define DASH_UPTIME		2		// minutes
+#define DASH_RX			3		// network frames received
+#define DASH_TX			4		// frames sent
+#define DASH_POOL		5		// free packets
+#define DASH_NONE		0xFF
+
+extern void dash_config(uint8_t template, uint16_t interval);
+extern uint8_t dash_active(void);
+extern void dash_poll(void);
+
+#endif
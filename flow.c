@@ -0,0 +1,83 @@
+/* Credit based flow control towards the host
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <avr/pgmspace.h>
+
+#include "uart.h"
+#include "clock.h"
+#include "net.h"
+#include "pool.h"
+#include "frag.h"
+#include "flow.h"
+
+static uint8_t enabled;
+static uint8_t consumed;	// host frames taken out of the uart ring
+static uint32_t last;
+
+/* frames for the radio the station can take right now */
+static uint8_t flow_frames(void)
+{
+	uint8_t free = pool_available();
+
+	/* txbuf is still being cut into fragments */
+	if(frag_busy())
+		return 0;
+	return free > FRAG_RESERVE ? free - FRAG_RESERVE : 0;
+}
+
+static void flow_report(void)
+{
+	printf_P(PSTR("10;49;%d;%d;%u\r\n"),consumed,flow_frames(),UART_RX_BUFFER_SIZE - 1);
+	last = clock_ms();
+}
+
+void flow_config(uint8_t on)
+{
+	/* the answer comes from flow_update(), with this frame as 1 */
+	enabled = on;
+	consumed = 0;
+}
+
+/* 1 if the host had a credit for a frame to dst */
+uint8_t flow_grant(uint8_t dst)
+{
+	if(!enabled || flow_frames())
+		return 1;
+	printf_P(PSTR("10;50;%d\r\n"),dst);
+	return 0;
+}
+
+/* a host frame was handled */
+void flow_update(void)
+{
+	if(!enabled)
+		return;
+	consumed++;
+	flow_report();
+}
+
+void flow_poll(void)
+{
+	if(enabled && clock_ms() - last >= FLOW_HEARTBEAT_MS)
+		flow_report();
+}
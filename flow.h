@@ -0,0 +1,44 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_FLOW_H__
+#define __DEFINE_FLOW_H__
+
+/* Credit based flow control towards the host
+ *
+ * Off until COMMAND_SET_FLOW turns it on. Then the station answers
+ * every host frame with "10;49;seq;frames;bytes" and repeats it every
+ * FLOW_HEARTBEAT_MS. seq counts the host frames the station has taken
+ * out of its uart receive ring (mod 256, the COMMAND_SET_FLOW frame
+ * that switched it on is 1). Frames sent after that one may still be
+ * in the ring and are not accounted for yet, so the credits are a
+ * window behind seq: the host may have up to "frames" frames and
+ * "bytes" bytes (the whole ring) under way past frame seq. Every line
+ * states the full window again, a lost or repeated one does no harm.
+ * A frame for the radio without a credit is refused with "10;50;dst". */
+#define FLOW_HEARTBEAT_MS	500
+
+extern void flow_config(uint8_t on);
+extern uint8_t flow_grant(uint8_t dst);
+extern void flow_update(void);
+extern void flow_poll(void);
+
+#endif
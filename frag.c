@@ -0,0 +1,195 @@
+/* Fragmentation and reassembly
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "uart.h"
+#include "clock.h"
+#include "net.h"
+#include "pool.h"
+#include "frag.h"
+#include "tag.h"
+
+/* frame being cut into fragments */
+struct frag_tx {
+	uint8_t *data;		// NULL = idle
+	uint8_t len;
+	uint8_t pos;
+	uint8_t dst;
+	uint8_t prio;
+	uint8_t id;
+	uint8_t index;
+	uint8_t count;
+	uint8_t tag;
+};
+
+/* frame being put together, fragments are pool packets with the
+ * fragment index in dst */
+struct frag_rx {
+	uint8_t src;
+	uint8_t id;
+	uint8_t count;		// 0 = context unused
+	uint8_t received;	// bit per fragment
+	uint32_t start;
+	struct packet_list list;
+};
+
+static struct frag_tx tx;
+static struct frag_rx contexts[FRAG_CONTEXTS];
+static uint8_t tx_id;
+
+void frag_init(void)
+{
+	tx.data = 0;
+	memset(contexts, 0, sizeof(contexts));
+}
+
+/* data has to stay untouched until frag_busy() returns 0 */
+void frag_send(uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio)
+{
+	tx.data = data;
+	tx.len = len;
+	tx.pos = 0;
+	tx.dst = dst;
+	tx.prio = prio;
+	tx.id = ++tx_id;
+	tx.index = 0;
+	tx.count = (len + FRAG_DATA_SIZE - 1) / FRAG_DATA_SIZE;
+	tx.tag = tag_current;
+}
+
+uint8_t frag_busy(void)
+{
+	return tx.data != 0;
+}
+
+static void frag_free(struct frag_rx *c)
+{
+	uint8_t p;
+
+	while((p = pool_list_get(&c->list)) != POOL_NONE)
+		pool_free(p);
+	c->count = 0;
+}
+
+static void frag_deliver(struct frag_rx *c)
+{
+	uint8_t i, k, p, tag;
+
+	tag = tag_swap(tag_reply(c->src));
+	tag_line();
+	for(i=0;i<c->count;i++)
+		for(p=c->list.head;p!=POOL_NONE;p=pool[p].next)
+			if(pool[p].dst == i)
+				for(k=0;k<pool[p].len;k++)
+					uart_putc(pool[p].data[k]);
+	tag_swap(tag);
+	frag_free(c);
+}
+
+void frag_rx(uint8_t src, uint8_t *data, uint8_t len)
+{
+	struct frag_rx *c = 0;
+	uint8_t i, p, index, count;
+
+	if(len < FRAG_HEADER_SIZE)
+		return;
+	index = data[1];
+	count = data[2];
+	if(!count || count > FRAG_MAX || index >= count)
+		return;
+
+	for(i=0;i<FRAG_CONTEXTS && !c;i++)
+		if(contexts[i].count && contexts[i].src == src && contexts[i].id == data[0])
+			c = &contexts[i];
+	for(i=0;i<FRAG_CONTEXTS && !c;i++)
+		if(!contexts[i].count)
+		{
+			/* the whole frame has to fit into the pool */
+			if(pool_available() <= FRAG_RESERVE || count > pool_available() - FRAG_RESERVE)
+			{
+				printf_P(PSTR("10;29;%d;%d;0\r\n"),src,data[0]);
+				return;
+			}
+			c = &contexts[i];
+			c->src = src;
+			c->id = data[0];
+			c->count = count;
+			c->received = 0;
+			c->start = clock_ms();
+			pool_list_init(&c->list);
+		}
+	if(!c || c->count != count || (c->received & (1 << index)))
+		return;
+
+	if(pool_available() <= FRAG_RESERVE || (p = pool_alloc()) == POOL_NONE)
+	{
+		printf_P(PSTR("10;29;%d;%d;%d\r\n"),src,c->id,c->received);
+		frag_free(c);
+		return;
+	}
+	pool[p].dst = index;
+	pool[p].len = len - FRAG_HEADER_SIZE;
+	memcpy(pool[p].data, &data[FRAG_HEADER_SIZE], pool[p].len);
+	pool_list_put(&c->list, p);
+	c->received |= 1 << index;
+
+	if(c->received == (1 << count) - 1)
+		frag_deliver(c);
+}
+
+/* queues the next outgoing fragment and gives up stale incoming frames */
+void frag_poll(void)
+{
+	uint32_t now = clock_ms();
+	uint8_t i, n, tag, *buf;
+
+	for(i=0;i<FRAG_CONTEXTS;i++)
+		if(contexts[i].count && now - contexts[i].start > FRAG_TIMEOUT_MS)
+		{
+			printf_P(PSTR("10;29;%d;%d;%d\r\n"),contexts[i].src,contexts[i].id,contexts[i].received);
+			frag_free(&contexts[i]);
+		}
+
+	if(!tx.data || pool_available() <= FRAG_RESERVE)
+		return;
+
+	n = tx.len - tx.pos;
+	if(n > FRAG_DATA_SIZE)
+		n = FRAG_DATA_SIZE;
+	buf = net_payload();
+	buf[0] = tx.id;
+	buf[1] = tx.index++;
+	buf[2] = tx.count;
+	memcpy(&buf[FRAG_HEADER_SIZE], &tx.data[tx.pos], n);
+	tag = tag_swap(tx.tag);
+	net_send_type(NET_TYPE_FRAG, tx.dst, buf, FRAG_HEADER_SIZE + n, tx.prio);
+	tx.pos += n;
+	if(tx.pos == tx.len)
+	{
+		printf_P(PSTR("10;28;%d;%d;%d\r\n"),tx.dst,tx.id,tx.count);
+		tx.data = 0;
+	}
+	tag_swap(tag);
+}
@@ -0,0 +1,52 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_FRAG_H__
+#define __DEFINE_FRAG_H__
+
+/* Fragmentation of frames that don't fit into one RF packet
+ *
+ * NET_TYPE_FRAG payload: id | index | count | data ...
+ *
+ * Outgoing fragments are cut straight out of the host frame buffer,
+ * the main loop stops reading the uart until the last one is queued.
+ * They take a pool packet only while queued, so any host frame (up to
+ * 255 bytes, 7 fragments) can be sent.
+ *
+ * Incoming fragments wait in the packet pool until the frame is
+ * complete, so a frame can't have more fragments than the pool has
+ * packets beyond FRAG_RESERVE: 6 * 37 = 222 bytes with the default
+ * sizes. A first fragment announcing more than the pool has free right
+ * now is dropped with 10;29. */
+#define FRAG_HEADER_SIZE	3
+#define FRAG_DATA_SIZE		(NET_MAX_PAYLOAD - FRAG_HEADER_SIZE)
+#define FRAG_RESERVE		2		// pool packets left for other traffic
+#define FRAG_MAX			(POOL_PACKETS - FRAG_RESERVE)	// fragments per incoming frame
+#define FRAG_CONTEXTS		2		// frames reassembled at once
+#define FRAG_TIMEOUT_MS		2000	// until an incomplete frame is given up
+
+extern void frag_init(void);
+extern void frag_send(uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio);
+extern uint8_t frag_busy(void);
+extern void frag_rx(uint8_t src, uint8_t *data, uint8_t len);
+extern void frag_poll(void);
+
+#endif
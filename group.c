@@ -0,0 +1,174 @@
+/* Broadcast and multicast groups
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "clock.h"
+#include "net.h"
+#include "group.h"
+#include "tag.h"
+#include "config.h"
+
+/* acknowledges collected for the last group frame sent with ack flag */
+struct group_ack {
+	struct group *group;
+	uint8_t seq;
+	uint16_t acked;		// bit per member
+	uint32_t start;
+	uint8_t tag;
+};
+
+struct group groups[GROUPS];
+static struct group_ack pending;
+
+static void group_ack_report(void);
+
+/* groups[] is kept as the config log loaded it */
+void group_init(void)
+{
+	pending.group = 0;
+}
+
+static struct group *group_find(uint8_t addr)
+{
+	uint8_t i;
+
+	for(i=0;i<GROUPS;i++)
+		if(groups[i].count && groups[i].addr == addr)
+			return &groups[i];
+	return 0;
+}
+
+/* count 0 deletes the group */
+void group_set(uint8_t addr, uint8_t *members, uint8_t count)
+{
+	struct group *g = group_find(addr);
+	uint8_t i;
+
+	if(count > GROUP_MEMBERS)
+		count = GROUP_MEMBERS;
+	for(i=0;i<GROUPS && !g;i++)
+		if(!groups[i].count)
+			g = &groups[i];
+	if(g && NET_IS_MULTI(addr) && addr != NET_BROADCAST)
+	{
+		if(pending.group == g)
+			pending.group = 0;
+		g->addr = addr;
+		g->count = count;
+		memcpy(g->members, members, count);
+		config_save();
+	}
+	group_report(addr);
+}
+
+/* 10;24;group;member;member;... */
+void group_report(uint8_t addr)
+{
+	struct group *g = group_find(addr);
+	uint8_t i;
+
+	printf_P(PSTR("10;24;%d"),addr);
+	for(i=0;g && i<g->count;i++)
+		printf_P(PSTR(";%d"),g->members[i]);
+	printf_P(PSTR("\r\n"));
+}
+
+/* flags are NET_FLAG_ACK and NET_FLAG_AT */
+void group_send(uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio, uint8_t flags)
+{
+	struct group *g;
+	uint8_t seq, *frame;
+
+	g = group_find(dst);
+	if(dst != NET_BROADCAST && !g)
+	{
+		printf_P(PSTR("10;65;%d\r\n"),dst);
+		return;
+	}
+	if(len > NET_MAX_PAYLOAD - (g ? 1 + g->count : 0))
+	{
+		printf_P(PSTR("10;64;%d\r\n"),dst);
+		return;
+	}
+	if(dst == NET_BROADCAST)
+	{
+		/* no member list to collect acks from */
+		net_frame(NET_TYPE_DATA | (flags & ~NET_FLAG_ACK), NET_BROADCAST,
+			NET_BROADCAST, data, len, prio);
+		return;
+	}
+
+	frame = net_payload();
+	frame[0] = g->count;
+	memcpy(&frame[1], g->members, g->count);
+	memcpy(&frame[1 + g->count], data, len);
+	seq = net_frame(NET_TYPE_MULTICAST | flags, dst,
+		NET_BROADCAST, frame, 1 + g->count + len, prio);
+
+	/* nothing went out, nothing to collect */
+	if(seq && (flags & NET_FLAG_ACK))
+	{
+		/* a still open collection is reported as it is */
+		if(pending.group)
+			group_ack_report();
+		pending.group = g;
+		pending.seq = seq;
+		pending.acked = 0;
+		pending.start = clock_ms();
+		pending.tag = tag_current;
+	}
+}
+
+void group_ack(uint8_t node, uint8_t seq)
+{
+	uint8_t i;
+
+	if(!pending.group || pending.seq != seq)
+		return;
+	for(i=0;i<pending.group->count;i++)
+		if(pending.group->members[i] == node)
+			pending.acked |= 1 << i;
+}
+
+/* 10;25;group;seq;acked members (bit mask);member count */
+static void group_ack_report(void)
+{
+	uint8_t tag = tag_swap(pending.tag);
+
+	printf_P(PSTR("10;25;%d;%d;%u;%d\r\n"),pending.group->addr,pending.seq,
+		pending.acked,pending.group->count);
+	tag_swap(tag);
+	pending.group = 0;
+}
+
+/* report as soon as everybody answered or the time is up */
+void group_poll(void)
+{
+	if(!pending.group)
+		return;
+	if(pending.acked == (1 << pending.group->count) - 1 ||
+		clock_ms() - pending.start > GROUP_ACK_MS)
+		group_ack_report();
+}
@@ -0,0 +1,50 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_GROUP_H__
+#define __DEFINE_GROUP_H__
+
+/* Multicast groups
+ *
+ * A group frame goes out once to the broadcast link address and
+ * carries the member list in front of the data, so the nodes don't
+ * have to know which groups they belong to. */
+#define GROUPS			4		// groups defined at once
+#define GROUP_MEMBERS	12		// max. members per group
+#define GROUP_ACK_MS	1000	// time the members get to acknowledge
+
+/* kept in the config log (see config.h) */
+struct group {
+	uint8_t addr;
+	uint8_t count;		// 0 = slot unused
+	uint8_t members[GROUP_MEMBERS];
+};
+
+extern struct group groups[GROUPS];
+
+extern void group_init(void);
+extern void group_set(uint8_t group, uint8_t *members, uint8_t count);
+extern void group_report(uint8_t group);
+extern void group_send(uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio, uint8_t flags);
+extern void group_ack(uint8_t node, uint8_t seq);
+extern void group_poll(void);
+
+#endif
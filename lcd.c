@@ -1,6 +1,9 @@
 /* Minimalistic lcd lib
  * 16x2 lcd
  *
+ * lcd_puts() and friends only write into a framebuffer, lcd_tick()
+ * brings the changed cells to the display a nibble at a time.
+ *
  * Copyright (C) 2007-2008 Bjoern Biesenbach <bjoern@bjoern-b.de>
  *
  * This program is free software; you can redistribute it and/or
@@ -21,7 +24,9 @@
  */
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
 #include <util/delay.h>
+#include <string.h>
 #include "lcd.h"
 
 #define LCD_PORT PORTA
@@ -30,10 +35,20 @@
 #define LCD_E PA5
 #define LCD_RS PA4
 
-static uint8_t x,y;
+#define LCD_NOWHERE	0xFF
+
+static char fb[LCD_CELLS];			// what the display should show
+static volatile uint32_t dirty;		// bit per cell that differs from the display
+static uint8_t x;					// lcd_puts() position, 0-31
+static uint8_t hw_pos;				// cell the display's address counter is on
+static uint8_t out, out_rs;			// byte being written by lcd_tick()
+static uint8_t out_nibbles;			// nibbles of it still to go
+static uint8_t glyphs[8][8];		// custom characters 0-7 (and 8-15)
+static volatile uint8_t glyph_dirty;	// bit per glyph to upload
+static uint8_t glyph, glyph_row;	// upload in progress, row 8 = none
+
 static void lcd_enable(void);
 static void lcd_command(uint8_t data);
-static void lcd_data(uint8_t data);
 
 static void lcd_enable()
 {
@@ -42,23 +57,7 @@ static void lcd_enable()
 	LCD_PORT &= ~(1<<LCD_E);	//LCD-Enable wieder low
 }
 
-static void lcd_data(uint8_t data)
-{
-	uint8_t temp=data;
-	data = data>>4;		//Die beiden Nibbles vertauschen
-	data &= 15;		//Oberes Nibble auf Null setzen (0b00001111)
-	data |= 16;		//0b00010000 also Bit 5 auf 1
-	LCD_PORT = (data & 0x3F) | (LCD_PORT & 0xC0);
-	lcd_enable();
-	temp &= 15;		//Nibble schon an der richtigen Stelle, oberes wieder
-				// auf Null
-	temp |= 16;
-	LCD_PORT = (temp & 0x3F) | (LCD_PORT & 0xC0);
-	lcd_enable();
-	_delay_us(50);
-}
-
-static void lcd_command(uint8_t data) //Wie lcd_data nur ohne RS zu setzen
+static void lcd_command(uint8_t data) //nur noch fuer lcd_init, danach macht das lcd_tick
 {
 	uint8_t temp=data;
 	data = data>>4;		//Die beiden Nibbles vertauschen
@@ -92,52 +91,184 @@ void lcd_init()
 	_delay_ms(5);
 	lcd_command(40);
 	lcd_command(12);
-	lcd_command(4);
+	lcd_command(6);		// cursor moves right, lcd_tick relies on it
+	/* whatever is on the display, everything gets written once */
+	for(i=0;i<LCD_CELLS;i++)
+		fb[i] = ' ';
+	dirty = 0xFFFFFFFFUL;
+	hw_pos = LCD_NOWHERE;
+	out_nibbles = 0;
+	glyph_dirty = 0;
+	glyph_row = 8;
+	x = 0;
+}
+
+/* the main loop only touches the framebuffer */
+static void lcd_set(uint8_t cell, char c)
+{
+	uint8_t sreg;
+
+	if(fb[cell] == c)
+		return;
+	fb[cell] = c;
+	sreg = SREG;
+	cli();
+	dirty |= 1UL << cell;
+	SREG = sreg;
+}
+
+static void lcd_putc(char c)
+{
+	lcd_set(x, c);
+	if(++x == LCD_CELLS)
+		x = 0;
 }
 
 void lcd_clear()
 {
-	lcd_command(1);
-	_delay_ms(5);
+	uint8_t i;
+
+	for(i=0;i<LCD_CELLS;i++)
+		lcd_set(i, ' ');
 	x=0;
-	y=0;
+}
+
+/* what the display shows (or is about to), LCD_CELLS characters */
+void lcd_read(char *text)
+{
+	memcpy(text, fb, LCD_CELLS);
 }
 
 void lcdInt(uint8_t value)
 {
 	if(value<10)
 	{
-		lcd_data('0');
-		lcd_data(value+48);
+		lcd_putc('0');
+		lcd_putc(value+48);
 	}
 	if(value>=10 && value<100)
 	{
-		lcd_data(value/10+48);
-		lcd_data(value%10+48);
+		lcd_putc(value/10+48);
+		lcd_putc(value%10+48);
 	}
 	if(value>=100)
 	{
-		lcd_data(value/100+48);
+		lcd_putc(value/100+48);
 		value %=100;
-		lcd_data(value/10+48);
-		lcd_data(value%10+48);
+		lcd_putc(value/10+48);
+		lcd_putc(value%10+48);
 	}
 }
 
 void lcd_puts(char *string)
 {
 	while(*string)
+		lcd_putc(*string++);
+}
+
+/* row 0-1, col 0-15 */
+void lcd_goto(uint8_t row, uint8_t col)
+{
+	x = ((row & 1) << 4) | (col & 15);
+}
+
+/* like lcd_puts, but may contain glyph 0 */
+void lcd_write(char *data, uint8_t len)
+{
+	while(len--)
+		lcd_putc(*data++);
+}
+
+/* text cut or filled with blanks to width */
+void lcd_field(uint8_t row, uint8_t col, uint8_t width, char *data, uint8_t len)
+{
+	lcd_goto(row, col);
+	while(width--)
 	{
-		lcd_data(*string++);
-		if(++x == 16)
-		{
-			lcd_command(0x80+0x40);
-		}
-		else if(x == 32)
+		if(len)
 		{
-			lcd_command(0x80);
-			x = 0;
+			lcd_putc(*data++);
+			len--;
 		}
+		else
+			lcd_putc(' ');
 	}
 }
 
+/* 8 rows of 5 pixels, shows up as character index and index + 8 */
+void lcd_glyph(uint8_t index, uint8_t *rows)
+{
+	uint8_t i, sreg;
+
+	index &= 7;
+	for(i=0;i<8;i++)
+		glyphs[index][i] = rows[i];
+	sreg = SREG;
+	cli();
+	glyph_dirty |= 1 << index;
+	SREG = sreg;
+}
+
+/* picks the next byte for the display, glyphs first */
+static uint8_t lcd_next(void)
+{
+	uint8_t cell;
+
+	if(glyph_row < 8)
+	{
+		out = glyphs[glyph][glyph_row++];
+		out_rs = 1<<LCD_RS;
+		return 1;
+	}
+	if(glyph_dirty)
+	{
+		for(glyph=0;!(glyph_dirty & (1 << glyph));glyph++);
+		glyph_dirty &= ~(1 << glyph);
+		glyph_row = 0;
+		/* cg ram address, the address counter leaves the display ram */
+		out = 0x40 | (glyph << 3);
+		out_rs = 0;
+		hw_pos = LCD_NOWHERE;
+		return 1;
+	}
+	if(!dirty)
+		return 0;
+	/* the cell under the address counter first, saves a command */
+	if(hw_pos != LCD_NOWHERE && (dirty & (1UL << hw_pos)))
+		cell = hw_pos;
+	else
+		for(cell=0;!(dirty & (1UL << cell));cell++);
+	if(cell != hw_pos)
+	{
+		out = 0x80 | (cell < 16 ? cell : 0x40 + cell - 16);
+		out_rs = 0;
+		hw_pos = cell;
+	}
+	else
+	{
+		out = fb[cell];
+		out_rs = 1<<LCD_RS;
+		dirty &= ~(1UL << cell);
+		/* the second line doesn't follow the first in the display ram */
+		hw_pos = (cell == 15 || cell == 31) ? LCD_NOWHERE : cell + 1;
+	}
+	return 1;
+}
+
+/* from the 1kHz timer: one nibble per call, far more than the 37us
+ * the display needs per byte */
+void lcd_tick(void)
+{
+	uint8_t n;
+
+	if(!out_nibbles)
+	{
+		if(!lcd_next())
+			return;
+		out_nibbles = 2;
+	}
+	n = (out_nibbles == 2) ? out >> 4 : out & 15;
+	LCD_PORT = n | out_rs | (LCD_PORT & 0xC0);
+	lcd_enable();
+	out_nibbles--;
+}
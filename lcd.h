@@ -22,9 +22,17 @@
 #ifndef __DEFINE_LCD_H__
 #define __DEFINE_LCD_H__
 
+#define LCD_CELLS	32
+
 extern void lcd_init(void);
 extern void lcd_puts(char *string);
 extern void lcdInt(uint8_t value);
 extern void lcd_clear(void);
+extern void lcd_tick(void);
+extern void lcd_goto(uint8_t row, uint8_t col);
+extern void lcd_write(char *data, uint8_t len);
+extern void lcd_field(uint8_t row, uint8_t col, uint8_t width, char *data, uint8_t len);
+extern void lcd_glyph(uint8_t index, uint8_t *rows);
+extern void lcd_read(char *text);
 
 #endif
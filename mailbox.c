@@ -0,0 +1,196 @@
+/* Mailboxes for duty-cycled nodes
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "clock.h"
+#include "net.h"
+#include "pool.h"
+#include "txq.h"
+#include "mailbox.h"
+#include "tag.h"
+#include "config.h"
+
+/* what is held, mailbox_setup[] says for whom */
+struct mailbox {
+	uint8_t count;
+	struct packet_list list;
+};
+
+struct mailbox_setup mailbox_setup[MAILBOX_NODES];
+static struct mailbox boxes[MAILBOX_NODES];
+static uint8_t held;		// frames in all mailboxes
+
+/* mailbox_setup[] is kept as the config log loaded it */
+void mailbox_init(void)
+{
+	uint8_t i;
+
+	for(i=0;i<MAILBOX_NODES;i++)
+	{
+		boxes[i].count = 0;
+		pool_list_init(&boxes[i].list);
+	}
+	held = 0;
+}
+
+/* index of the node's mailbox, MAILBOX_NODES if it has none */
+static uint8_t mailbox_find(uint8_t node)
+{
+	uint8_t i;
+
+	for(i=0;i<MAILBOX_NODES;i++)
+		if(mailbox_setup[i].depth && mailbox_setup[i].node == node)
+			break;
+	return i;
+}
+
+static void mailbox_flush(uint8_t i)
+{
+	uint8_t p;
+
+	while((p = pool_list_get(&boxes[i].list)) != POOL_NONE)
+		pool_free(p);
+	held -= boxes[i].count;
+	boxes[i].count = 0;
+}
+
+/* depth 0 removes the mailbox, held frames are dropped */
+void mailbox_config(uint8_t node, uint8_t depth, uint16_t expiry)
+{
+	uint8_t i = mailbox_find(node);
+
+	if(i == MAILBOX_NODES)
+	{
+		for(i=0;i<MAILBOX_NODES && mailbox_setup[i].depth;i++)
+			;
+		if(i == MAILBOX_NODES || !depth)
+		{
+			mailbox_report(node);
+			return;
+		}
+		mailbox_setup[i].node = node;
+	}
+	if(!depth)
+		mailbox_flush(i);
+	if(depth > MAILBOX_SHARE)
+		depth = MAILBOX_SHARE;
+	mailbox_setup[i].depth = depth;
+	mailbox_setup[i].expiry = expiry;
+	config_save();
+	mailbox_report(node);
+}
+
+void mailbox_report(uint8_t node)
+{
+	uint8_t i = mailbox_find(node);
+
+	if(i < MAILBOX_NODES)
+		printf_P(PSTR("10;15;%d;%d;%u;%d\r\n"),node,mailbox_setup[i].depth,
+			mailbox_setup[i].expiry,boxes[i].count);
+	else
+		printf_P(PSTR("10;15;%d;0;0;0\r\n"),node);
+}
+
+/* returns 0 if the node has no mailbox and the frame should be sent now,
+ * sign is 0 or NET_FLAG_AUTH */
+uint8_t mailbox_put(uint8_t node, uint8_t *data, uint8_t len, uint8_t prio, uint8_t sign)
+{
+	uint8_t i = mailbox_find(node);
+	uint8_t p;
+
+	if(i == MAILBOX_NODES)
+		return 0;
+
+	if(boxes[i].count >= mailbox_setup[i].depth || held >= MAILBOX_SHARE ||
+		len > POOL_DATA_SIZE || (p = pool_alloc()) == POOL_NONE)
+	{
+		printf_P(PSTR("10;18;%d;1\r\n"),node);
+		return 1;
+	}
+	pool[p].dst = node;
+	pool[p].len = len;
+	pool[p].stamp = clock_ms();
+	pool[p].tag = tag_current;
+	pool[p].prio = prio | sign;
+	memcpy(pool[p].data, data, len);
+	pool_list_put(&boxes[i].list, p);
+	boxes[i].count++;
+	held++;
+	printf_P(PSTR("10;16;%d;%d\r\n"),node,boxes[i].count);
+	return 1;
+}
+
+/* the node is awake, hand out everything we kept for it */
+void mailbox_deliver(uint8_t node)
+{
+	uint8_t i = mailbox_find(node);
+	uint8_t p, count, tag;
+
+	if(i == MAILBOX_NODES || !boxes[i].count)
+		return;
+
+	count = boxes[i].count;
+	while((p = pool_list_get(&boxes[i].list)) != POOL_NONE)
+	{
+		/* free it first, the tx queue may need the slot when the
+		 * pool is full. The data stays valid until it is copied. */
+		pool_free(p);
+		tag = tag_swap(pool[p].tag);
+		if(pool[p].prio & NET_FLAG_AUTH)
+			net_send_type(NET_TYPE_DATA | NET_FLAG_AUTH, node, pool[p].data,
+				pool[p].len, pool[p].prio & ~NET_FLAG_AUTH);
+		else
+			net_send(node, pool[p].data, pool[p].len, pool[p].prio);
+		tag_swap(tag);
+	}
+	held -= count;
+	boxes[i].count = 0;
+	printf_P(PSTR("10;17;%d;%d\r\n"),node,count);
+}
+
+/* drop frames nobody came to fetch in time */
+void mailbox_poll(void)
+{
+	uint32_t now = clock_ms();
+	uint8_t i, p, dropped;
+
+	for(i=0;i<MAILBOX_NODES;i++)
+	{
+		if(!mailbox_setup[i].depth || !mailbox_setup[i].expiry)
+			continue;
+		dropped = 0;
+		while((p = boxes[i].list.head) != POOL_NONE &&
+			now - pool[p].stamp >= mailbox_setup[i].expiry * 1000UL)
+		{
+			pool_list_get(&boxes[i].list);
+			pool_free(p);
+			boxes[i].count--;
+			held--;
+			dropped++;
+		}
+		if(dropped)
+			printf_P(PSTR("10;18;%d;%d\r\n"),mailbox_setup[i].node,dropped);
+	}
+}
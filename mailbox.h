@@ -0,0 +1,54 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_MAILBOX_H__
+#define __DEFINE_MAILBOX_H__
+
+/* Store-and-forward for sleeping nodes
+ *
+ * Frames for a node with a mailbox are kept in the packet pool until
+ * the node wakes up and sends a NET_TYPE_POLL frame, then all of them
+ * go out in one burst, each in the class it was sent with. Frames to
+ * be signed are signed then, so the counter in them is a fresh one.
+ *
+ * Held frames take packets the transmit queue needs as well, so all
+ * mailboxes together keep at most MAILBOX_SHARE of them; a bigger depth
+ * is cut down to that. */
+#define MAILBOX_NODES	4		// nodes that can have a mailbox at once
+#define MAILBOX_SHARE	(POOL_PACKETS / 2)	// packets all mailboxes may hold
+
+/* kept in the config log (see config.h) */
+struct mailbox_setup {
+	uint8_t node;
+	uint8_t depth;		// max. frames held, 0 = slot unused
+	uint16_t expiry;	// seconds, 0 = never
+};
+
+extern struct mailbox_setup mailbox_setup[MAILBOX_NODES];
+
+extern void mailbox_init(void);
+extern void mailbox_config(uint8_t node, uint8_t depth, uint16_t expiry);
+extern void mailbox_report(uint8_t node);
+extern uint8_t mailbox_put(uint8_t node, uint8_t *data, uint8_t len, uint8_t prio, uint8_t sign);
+extern void mailbox_deliver(uint8_t node);
+extern void mailbox_poll(void);
+
+#endif
@@ -35,34 +35,362 @@
 #include "rf12.h"
 #include "main.h"
 #include "lcd.h"
+#include "net.h"
+#include "clock.h"
+#include "pool.h"
+#include "mailbox.h"
+#include "airtime.h"
+#include "txq.h"
+#include "group.h"
+#include "compress.h"
+#include "frag.h"
+#include "ota.h"
+#include "beacon.h"
+#include "auth.h"
+#include "cache.h"
+#include "tag.h"
+#include "flow.h"
+#include "sniff.h"
+#include "cut.h"
+#include "dash.h"
+#include "relay.h"
+#include "buzzer.h"
+#include "rule.h"
+#include "counter.h"
+#include "config.h"
+#include "state.h"
+#include "telemetry.h"
 
 /* Port usage
  *
  * PORTA: PA0-PA5 LCD
  *        PA7 LCD Backlight active low
  *
- * PORTD: PD3-PD6 Digital inputs
+ * PORTD: PD3-PD6 Digital inputs (PD3 is TXD1 on the atmega324p)
  *        PD7 Buzzer
  */
 
-#define KEY_INPUT (PIND & ((1<<PD3)|(1<<PD4)|(1<<PD5)|(1<<PD6)))
-
-uint8_t relais_port_state;
 static volatile uint8_t mili_sec_counter, uartcount;
+static volatile uint8_t uart_timeout;	// 10;12 due, printed by the main loop
 static volatile char key_state, key_temp; 
 
+/* after a watchdog reset the newer parts keep the watchdog running at
+ * the shortest timeout, stop it before main */
+void wdt_init(void) __attribute__((naked, section(".init3")));
+void wdt_init(void)
+{
+#ifdef MCUSR
+	MCUSR = 0;
+#else
+	MCUCSR = 0;
+#endif
+	wdt_disable();
+}
+
+/* channel and rate from the config */
+static void radio_config(void)
+{
+	uint16_t rate = config_get(CONFIG_RF_RATE);
+
+	airtime_set_rate(rate);
+	rf12_config(rate, config_get(CONFIG_CHANNEL), 0, QUIET);
+}
+
+/* frames from the host that leave via rf */
+static void rf_send(uint8_t dst, uint8_t *data, uint8_t len, uint8_t flags)
+{
+	uint8_t prio = (flags & SEND_HIGH_PRIO) ? TXQ_HIGH : TXQ_LOW;
+	uint8_t sign = 0;
+
+	if(!flow_grant(dst))
+		return;
+#ifdef USE_AUTH
+	if(flags & SEND_AUTH)
+		sign = NET_FLAG_AUTH;
+#endif
+	/* one frame for a whole group */
+	if(NET_IS_MULTI(dst))
+	{
+		group_send(dst, data, len, prio, sign | ((flags & SEND_GROUP_ACK) ? NET_FLAG_ACK : 0));
+		return;
+	}
+	/* a sleeping node gets it when it asks for it, signed then */
+	if(mailbox_put(dst, data, len, prio, sign))
+		return;
+	if(sign)
+	{
+#ifdef USE_COMPRESSION
+		if(flags & SEND_COMPRESS)
+			comp_send(dst, data, len, prio, sign);
+		else
+#endif
+			net_send_type(NET_TYPE_DATA | sign, dst, data, len, prio);
+		return;
+	}
+	/* more than one RF packet, data stays in txbuf until it's out */
+	if(len > POOL_DATA_SIZE)
+	{
+		frag_send(dst, data, len, prio);
+		return;
+	}
+#ifdef USE_COMPRESSION
+	if(flags & SEND_COMPRESS)
+	{
+		comp_send(dst, data, len, prio, 0);
+		return;
+	}
+#endif
+	net_send(dst, data, len, prio);
+}
+
+/* data starts with the station time the node(s) should act at */
+static void rf_send_at(uint8_t dst, uint8_t *data, uint8_t len, uint8_t flags)
+{
+	uint8_t prio = (flags & SEND_HIGH_PRIO) ? TXQ_HIGH : TXQ_LOW;
+	uint8_t type = NET_FLAG_AT;
+
+	if(!flow_grant(dst))
+		return;
+#ifdef USE_AUTH
+	if(flags & SEND_AUTH)
+		type |= NET_FLAG_AUTH;
+#endif
+	if(NET_IS_MULTI(dst))
+		group_send(dst, data, len, prio, type | ((flags & SEND_GROUP_ACK) ? NET_FLAG_ACK : 0));
+	else if(len <= NET_MAX_PAYLOAD)
+		net_send_type(NET_TYPE_DATA | type, dst, data, len, prio);
+	else
+		printf_P(PSTR("10;64;%d\r\n"),dst);
+}
+
+/* a complete frame from the host */
+static void host_frame(uint8_t dst, uint8_t *buf, uint8_t numbytes)
+{
+	uint32_t value;
+	uint8_t i;
+
+	/* is the packet for me? */
+	if(dst == MY_ADDRESS)
+	{
+		/* buf[0] = command */
+		switch(buf[0])
+		{
+			case COMMAND_SET_RELAIS:
+						 relay_write(buf[1]);
+						 break;
+			case COMMAND_GET_RELAIS:
+						 relay_report();
+						 break;
+			case COMMAND_ACTIVATE_LCD: 
+						 PORTA &= ~(1<<PA7);
+						 break;
+			case COMMAND_DEACTIVATE_LCD: 
+						 PORTA |= (1<<PA7);
+						 break;
+			case COMMAND_BEEP_ON: 
+						 buzzer_set(1);
+						 break;
+			case COMMAND_BEEP_OFF: 
+						 buzzer_set(0);
+						 break;
+			case COMMAND_BUZZER_PATTERN:
+						 printf_P(PSTR("10;58;%d\r\n"),buzzer_pattern(&buf[1],numbytes-1));
+						 break;
+			case COMMAND_BUZZER_PLAY:
+						 printf_P(PSTR("10;59;%d;%d\r\n"),buf[1],buzzer_play(buf[1],buf[2]));
+						 break;
+			case COMMAND_SET_CONFIG:
+						 value = 0;
+						 for(i=2;i<numbytes;i++)
+							 value = (value << 8) | buf[i];
+						 if(numbytes < 3 || !config_set(buf[1],value))
+							 printf_P(PSTR("10;61;%d\r\n"),buf[1]);
+						 else
+						 {
+							 if(buf[1] != CONFIG_ADDRESS && buf[1] != CONFIG_UART_RATE)
+								 radio_config();
+							 config_report(buf[1]);
+						 }
+						 break;
+			case COMMAND_GET_CONFIG:
+						 config_report(buf[1]);
+						 break;
+			case COMMAND_GET_STATE:
+						 state_report();
+						 break;
+			case COMMAND_SUBSCRIBE:
+						 state_subscribe(buf[1],(buf[2]<<8)|buf[3]);
+						 break;
+			case COMMAND_LCD_TEXT: 
+						 lcd_clear();
+						 lcd_puts((char*)&buf[1]);
+						 break;
+			case COMMAND_SET_ROUTE:
+						 printf_P(PSTR("10;14;%d;%d\r\n"),buf[1],net_set_route(buf[1],buf[2]));
+						 break;
+			case COMMAND_GET_ROUTE:
+						 printf_P(PSTR("10;14;%d;%d\r\n"),buf[1],net_get_route(buf[1]));
+						 break;
+			case COMMAND_SET_MAILBOX:
+						 mailbox_config(buf[1],buf[2],(buf[3]<<8)|buf[4]);
+						 break;
+			case COMMAND_GET_MAILBOX:
+						 mailbox_report(buf[1]);
+						 break;
+			case COMMAND_SET_AIRTIME:
+						 airtime_config(buf[1],(buf[2]<<8)|buf[3],(buf[4]<<8)|buf[5],buf[6]);
+						 break;
+			case COMMAND_GET_AIRTIME:
+						 airtime_report();
+						 break;
+			case COMMAND_RF_SEND:
+						 if(numbytes >= 3)
+							 rf_send(buf[1],&buf[3],numbytes-3,buf[2]);
+						 break;
+			case COMMAND_GET_TXQ:
+						 txq_report();
+						 break;
+			case COMMAND_SET_GROUP:
+						 if(numbytes >= 2)
+							 group_set(buf[1],&buf[2],numbytes-2);
+						 break;
+			case COMMAND_GET_GROUP:
+						 group_report(buf[1]);
+						 break;
+#ifdef USE_COMPRESSION
+			case COMMAND_GET_COMPRESSION:
+						 comp_report();
+						 break;
+#endif
+			case COMMAND_OTA_START:
+						 ota_start(buf[1],(buf[2]<<8)|buf[3]);
+						 break;
+			case COMMAND_OTA_BLOCK:
+						 if(numbytes >= 3)
+							 ota_block((buf[1]<<8)|buf[2],&buf[3],numbytes-3);
+						 break;
+			case COMMAND_RF_SEND_AT:
+						 if(numbytes >= 7)
+							 rf_send_at(buf[1],&buf[3],numbytes-3,buf[2]);
+						 break;
+			case COMMAND_GET_TIME:
+						 printf_P(PSTR("10;41;%lu\r\n"),clock_ms());
+						 break;
+			case COMMAND_SET_BEACON:
+						 beacon_config((buf[1]<<8)|buf[2]);
+						 break;
+#ifdef USE_AUTH
+			case COMMAND_SET_KEY:
+						 if(numbytes == 17)
+							 auth_set_key(&buf[1]);
+						 break;
+			case COMMAND_AUTH_BENCH:
+						 auth_bench();
+						 break;
+#endif
+			case COMMAND_GET_VALUE:
+						 cache_get(buf[1],buf[2]);
+						 break;
+			case COMMAND_GET_VALUES:
+						 cache_dump();
+						 break;
+			case COMMAND_TAG:
+						 /* a tagged frame can't carry another tag, no recursion */
+						 if(numbytes >= 3 && !(buf[2] == MY_ADDRESS && numbytes > 3 && buf[3] == COMMAND_TAG))
+						 {
+							 tag_current = buf[1];
+							 host_frame(buf[2],&buf[3],numbytes-3);
+							 tag_current = 0;
+						 }
+						 break;
+			case COMMAND_SET_FLOW:
+						 flow_config(buf[1]);
+						 break;
+			case COMMAND_SET_SNIFFER:
+						 sniff_config(buf[1]);
+						 break;
+			case COMMAND_SET_CUT:
+						 cut_config(buf[1]);
+						 break;
+			case COMMAND_GET_LATENCY:
+						 cut_report();
+						 break;
+			case COMMAND_LCD_AT:
+						 if(numbytes >= 3)
+						 {
+							 lcd_goto(buf[1],buf[2]);
+							 lcd_write((char*)&buf[3],numbytes-3);
+						 }
+						 break;
+			case COMMAND_LCD_FIELD:
+						 if(numbytes >= 4)
+							 lcd_field(buf[1],buf[2],buf[3],(char*)&buf[4],numbytes-4);
+						 break;
+			case COMMAND_LCD_GLYPH:
+						 if(numbytes == 10)
+							 lcd_glyph(buf[1],&buf[2]);
+						 break;
+			case COMMAND_SET_COUNTER:
+						 counter_config(buf[1],(buf[2]<<8)|buf[3]);
+						 break;
+			case COMMAND_GET_COUNTERS:
+						 counter_report();
+						 break;
+			case COMMAND_SET_DASH:
+						 dash_config(buf[1],(buf[2]<<8)|buf[3]);
+						 break;
+			case COMMAND_RELAIS_SET:
+						 relay_set(buf[1]);
+						 relay_report();
+						 break;
+			case COMMAND_RELAIS_CLEAR:
+						 relay_clear(buf[1]);
+						 relay_report();
+						 break;
+			case COMMAND_RELAIS_TOGGLE:
+						 relay_toggle(buf[1]);
+						 relay_report();
+						 break;
+			case COMMAND_RELAIS_PULSE:
+						 relay_pulse(buf[1],(buf[2]<<8)|buf[3]);
+						 relay_report();
+						 break;
+			case COMMAND_RELAIS_AUTOOFF:
+						 relay_autooff(buf[1],(buf[2]<<8)|buf[3]);
+						 break;
+			case COMMAND_SET_RULE:
+						 if(numbytes >= 2)
+							 rule_set(buf[1],&buf[2],numbytes-2);
+						 break;
+			case COMMAND_GET_RULE:
+						 rule_report(buf[1]);
+						 break;
+		}
+	}
+	/* packet is not for me, send it via rf */
+	else
+	{
+		rf_send(dst, buf, numbytes, 0);
+	}
+}
+
 int main(void)
 {
 	unsigned char destination = 0;
 	unsigned char rxbyte,txbuf[255],numbytes=0,uart_dest=0;
+	uint8_t i;
+
+	/* before anything that depends on the address or rates */
+	config_init();
 
-	uart_init(UART_BAUD_SELECT(UART_BAUDRATE, F_CPU));
+	uart_init(UART_BAUD_SELECT(config_get(CONFIG_UART_RATE), F_CPU));
 
 	/* now we can use printf. the output goes to uart */
-	fdevopen((void*)uart_putc,NULL);
+	fdevopen((void*)tag_putc,NULL);
+	telemetry_init();
 
 	/* say hello! command to tell had that a hard-reset occured */
-	printf("%d;%d;%d;%d\r\n",10,10,0,0);
+	printf_P(PSTR("%d;%d;%d;%d\r\n"),10,10,0,0);
 
 	lcd_init();
 	lcd_clear();
@@ -80,27 +408,63 @@ int main(void)
 
 	
 	/* Prescaler 1024 */
+#ifdef TIMSK0
+	TCCR0B = (1<<CS02) | (1<<CS00);
+	TIMSK0 = (1<<TOIE0);
+#else
 	TCCR0 = (1<<CS02) | (1<<CS00);
 	TIMSK = (1<<TOIE0);
+#endif
+
+	/* 1ms timebase on timer2 */
+	clock_init();
 
 	/* init rfm12
 	 * 1 is for first init (with delay loop) */
 	rf12_init(1);
+	pool_init();
+	airtime_init(config_get(CONFIG_RF_RATE));
+	txq_init();
+	net_init();
+	mailbox_init();
+	group_init();
+#ifdef USE_COMPRESSION
+	comp_init();
+#endif
+	frag_init();
+	ota_init();
+	beacon_init();
+#ifdef USE_AUTH
+	auth_init();
+#endif
+	cache_init();
+	tag_init();
+	counter_init();
 
 	sei();
 
 	/* Badurate, Channel .... */
-	rf12_config(RF_BAUDRATE, CHANNEL, 0, QUIET);
+	rf12_config(config_get(CONFIG_RF_RATE), config_get(CONFIG_CHANNEL), 0, QUIET);
 
-	key_state = KEY_INPUT;
+	key_state = counter_inputs();
 
 	for (;;)
 	{       
 		if(!uartcount)	
 			mili_sec_counter = 0;
 
-		/* data in the uart buffer? */
-		if (uart_data())
+		/* the timer dropped a half received host frame. Printed here,
+		 * output from the interrupt would get between the bytes (and
+		 * under the tag) of whatever the loop is printing. */
+		if(uart_timeout)
+		{
+			uart_timeout = 0;
+			printf_P(PSTR("%d;%d;%d;%d\r\n"),10,12,0,0);
+		}
+
+		/* data in the uart buffer? (not while txbuf is being
+		 * fragmented) */
+		if (uart_data() && !frag_busy())
 		{       
 			/* first byte: destination
 			 * second byte: number of data bytes */
@@ -114,87 +478,58 @@ int main(void)
 			/* last byte received? */
 			if(numbytes==uartcount-2)
 			{
-				/* is the packet for me? */
-				if(uart_dest == MY_ADDRESS)
-				{
-					/* txbuf[0] = command */
-					switch(txbuf[0])
-					{
-						case COMMAND_SET_RELAIS: relais_port_state = txbuf[1];
-									 PORTC = relais_port_state;
-									 break;
-						case COMMAND_GET_RELAIS:
-									 printf("10;13;%d\r\n",PORTC);
-									 break;
-						case COMMAND_ACTIVATE_LCD: 
-									 PORTA &= ~(1<<PA7);
-									 break;
-						case COMMAND_DEACTIVATE_LCD: 
-									 PORTA |= (1<<PA7);
-									 break;
-						case COMMAND_BEEP_ON: 
-									 PORTD &= ~(1<<PD7);
-									 break;
-						case COMMAND_BEEP_OFF: 
-									 PORTD |= (1<<PD7);
-									 break;
-						case COMMAND_LCD_TEXT: 
-									 lcd_clear();
-									 lcd_puts(&txbuf[1]);
-									 break;
-					}
-				}
-				/* packet is not for me, send it via rf */
-				else
-				{
-					rf12_txpacket(txbuf, numbytes, destination, 0);
-				}
+				host_frame(uart_dest, txbuf, numbytes);
+				flow_update();
 				uartcount=0;
 			}
 		}
 		
-		/* got data from rfm12? */
-		if (rf12_data())
+		/* got data from rfm12? (the timer takes it in cut-through mode) */
+		if (!cut_active())
 		{
-			unsigned char rxbyte = rf12_getchar();
-			/* put every byte to uart */
-			uart_putc(rxbyte);	
+			if (rf12_data())
+			{
+				/* relayed frames are unpacked, everything else goes
+				 * straight to the uart */
+				if(sniff_active())
+					sniff_rx(rf12_getchar());
+				else
+					net_rx(rf12_getchar());
+				cut_loop(1);
+			}
+			else
+				cut_loop(0);
 		}
+		sniff_poll();
+		net_poll();
+		mailbox_poll();
+		txq_poll();
+		group_poll();
+		frag_poll();
+		ota_poll();
+		beacon_poll();
+		flow_poll();
+		dash_poll();
+		counter_poll();
+		state_poll();
+		config_poll();
 
-		/* digital input changed? */
-		key_temp = KEY_INPUT;
+		/* digital input changed? (debounced by the clock) */
+		key_temp = counter_inputs();
 		if(key_state != key_temp)
 		{
-			if((key_temp & (1<<PD3)) != (key_state & (1<<PD3)))
-			{
-				if(key_temp& (1<<PD3)) // now open
-					printf("10;30;0;0\r\n");
-				else // now closed
-					printf("10;31;0;0\r\n");
-			}
-			if((key_temp & (1<<PD4)) != (key_state & (1<<PD4)))
-			{
-				if(key_temp & (1<<PD4)) // now open
-					printf("10;32;0;0\r\n");
-				else // now closed
-					printf("10;33;0;0\r\n");
-			}
-			if((key_temp & (1<<PD5)) != (key_state & (1<<PD5)))
+			/* local rules first, the host gets to know afterwards */
+			rule_inputs(key_state, key_temp);
+			/* with a summary interval or a subscription the host
+			 * gets them coalesced */
+			if(counter_edges() && !state_subscribed())
 			{
-				if(key_temp & (1<<PD5)) // now open
-					printf("10;34;0;0\r\n");
-				else // now closed
-					printf("10;35;0;0\r\n");
-			}
-			if((key_temp & (1<<PD6)) != (key_state & (1<<PD6)))
-			{
-				if(key_temp & (1<<PD6)) // now open
-					printf("10;36;0;0\r\n");
-				else // now closed
-					printf("10;37;0;0\r\n");
+				/* 10;30 PD3 now open, 10;31 PD3 now closed ... 10;37 PD6 */
+				for(i=0;i<COUNTER_INPUTS;i++)
+					if((key_temp ^ key_state) & (1<<(PD3+i)))
+						printf_P(PSTR("10;%d;0;0\r\n"),30 + 2*i + !(key_temp & (1<<(PD3+i))));
 			}
 			key_state = key_temp;
-			_delay_ms(100);
 		}
 	}
 }
@@ -206,10 +541,12 @@ ISR(TIMER0_OVF_vect)
 	static uint8_t timeout_counter = 0;
 	TCNT0 = 255-156;
 
+	net_tick();
+
 	if(100 == mili_sec_counter++)
 	{
 		timeout_counter++;
-		printf("%d;%d;%d;%d\r\n",10,12,0,0);
+		uart_timeout = 1;
 		uartcount = 0;
 		mili_sec_counter = 0;
 	}
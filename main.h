@@ -2,6 +2,8 @@
 #define RF_BAUDRATE		20000		// Baudrate des RFM12 (nur gültig wenn kein DIP Schalter verwendet wird)
 #define UART_BAUDRATE	19200		// Baudrate des UARTs (nur gültig wenn kein DIP Schalter verwendet wird)
 #define PROTOKOLL_V2
+//#define USE_COMPRESSION		// dictionary/delta coding of RF payloads (SEND_COMPRESS), ~270 bytes RAM
+//#define USE_AUTH				// signed RF frames (SEND_AUTH), needs ~60 bytes RAM
 
 #define COMMAND_SET_RELAIS 0
 #define COMMAND_ACTIVATE_LCD 1
@@ -10,8 +12,67 @@
 #define COMMAND_BEEP_OFF 4
 #define COMMAND_LCD_TEXT 5
 #define COMMAND_GET_RELAIS 6
+#define COMMAND_SET_ROUTE 7		// dst, via (via 0 = direct)
+#define COMMAND_GET_ROUTE 8		// dst
+#define COMMAND_SET_MAILBOX 9	// node, depth (0 = off), expiry in s (high, low)
+#define COMMAND_GET_MAILBOX 10	// node
+#define COMMAND_SET_AIRTIME 11	// scope (0 band, 1 per dst), permille (high, low), burst ms (high, low), policy (0 queue, 1 reject)
+#define COMMAND_GET_AIRTIME 12
+#define COMMAND_RF_SEND 13		// dst, flags, data ...
+#define COMMAND_GET_TXQ 14
+#define COMMAND_SET_GROUP 15	// group (0xF0-0xFE), members ... (none = delete)
+#define COMMAND_GET_GROUP 16	// group
+#define COMMAND_GET_COMPRESSION 17
+#define COMMAND_OTA_START 18		// node, image size (high, low)
+#define COMMAND_OTA_BLOCK 19		// block (high, low), up to 32 data bytes
+#define COMMAND_RF_SEND_AT 20	// dst, flags, time in ms (4 bytes, high first), data ...
+#define COMMAND_GET_TIME 21
+#define COMMAND_SET_BEACON 22	// interval in s (high, low), 0 = off
+#define COMMAND_SET_KEY 23		// 16 bytes XTEA key, kept in the eeprom
+#define COMMAND_AUTH_BENCH 24
+#define COMMAND_GET_VALUE 25		// node, sensor
+#define COMMAND_GET_VALUES 26	// all cached values in one line
+#define COMMAND_TAG 27			// tag, destination, data ... (a host frame)
+#define COMMAND_SET_FLOW 28		// 1 = credits on, 0 = off
+#define COMMAND_SET_SNIFFER 29	// 1 = binary capture at SNIFF_BAUDRATE, 0 = off
+#define COMMAND_SET_CUT 30		// 1 = rf bytes forwarded from the timer interrupt, 0 = off
+#define COMMAND_GET_LATENCY 31
+#define COMMAND_LCD_AT 32		// row, col, text ...
+#define COMMAND_LCD_FIELD 33	// row, col, width, text ... (cut or filled with blanks)
+#define COMMAND_LCD_GLYPH 34	// index (0-7), 8 rows of 5 pixels
+#define COMMAND_SET_DASH 35		// template (0 = off), refresh in ms (high, low)
+#define COMMAND_RELAIS_SET 36	// mask of relays to switch on
+#define COMMAND_RELAIS_CLEAR 37	// mask of relays to switch off
+#define COMMAND_RELAIS_TOGGLE 38	// mask
+#define COMMAND_RELAIS_PULSE 39	// mask, ms (high, low)
+#define COMMAND_RELAIS_AUTOOFF 40	// mask, ms (high, low), 0 = off
+#define COMMAND_SET_RULE 41		// rule, event, arg, action, mask, param (high, low), data ... (only rule = delete)
+#define COMMAND_GET_RULE 42		// rule
+#define COMMAND_SET_COUNTER 43	// min. pulse width in ms, summary every s (high, low), 0 = per-edge lines
+#define COMMAND_GET_COUNTERS 44
+#define COMMAND_BUZZER_PATTERN 45	// durations in 10ms, on and off in turn (max. BUZZER_STEPS)
+#define COMMAND_BUZZER_PLAY 46	// pattern (0 = uploaded), repeats (0 = endless)
+#define COMMAND_SET_CONFIG 47	// key, value ... (high byte first, any for CONFIG_DEFAULTS)
+#define COMMAND_GET_CONFIG 48	// key
+#define COMMAND_GET_STATE 49		// inputs, relays, counters and LCD in one binary record
+#define COMMAND_SUBSCRIBE 50		// mode (0 = off, 1 = changes, 2 = always), interval in ms (high, low)
 
-#define MY_ADDRESS 0x02
+/* flags of COMMAND_RF_SEND */
+#define SEND_HIGH_PRIO 0x01		// jump the queue (actuators)
+#define SEND_GROUP_ACK 0x02		// collect acks of the group members
+#define SEND_COMPRESS 0x04		// compress the payload (node has to support it)
+#define SEND_AUTH 0x08			// sign the frame, max. NET_MAX_PAYLOAD - AUTH_SIZE bytes
+
+/* a frame from the host that can't go out is answered with one of
+ * 10;18;node;frames	mailbox full, or frames expired in it
+ * 10;19;dst		airtime limit, see airtime.h
+ * 10;22;dst		transmit queue full (no pool packet)
+ * 10;64;dst		too long for the send command
+ * 10;65;dst		group not defined
+ * 10;66;dst		payload (and signature) too long for a network frame */
+
+#define MY_ADDRESS_DEFAULT 0x02	// used until COMMAND_SET_CONFIG changes it
+#define MY_ADDRESS myAddress
 //#define DIP_KEYBOARD
 #define ADDRESS_DDR DDRC
 #define ADDRESS_PIN PINC
@@ -0,0 +1,348 @@
+/* Multi-hop relay layer on top of the rf12 lib
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "global.h"
+#include "uart.h"
+#include "main.h"
+#include "net.h"
+#include "mailbox.h"
+#include "txq.h"
+#include "group.h"
+#include "compress.h"
+#include "frag.h"
+#include "ota.h"
+#include "auth.h"
+#include "cache.h"
+#include "tag.h"
+#include "rule.h"
+#include "config.h"
+
+struct net_route net_routes[NET_ROUTES];
+static uint16_t dup_cache[NET_DUP_CACHE];
+static uint8_t dup_pos, tx_seq;
+uint16_t net_received;
+
+static uint8_t tx_frame[NET_HEADER_SIZE + NET_MAX_PAYLOAD];
+static uint8_t rx_frame[NET_HEADER_SIZE + NET_MAX_PAYLOAD];
+static uint8_t rx_pos;
+static volatile uint8_t rx_idle;
+
+/* net_routes[] is kept as the config log loaded it */
+void net_init(void)
+{
+	memset(dup_cache, 0xFF, sizeof(dup_cache));
+	dup_pos = 0;
+	rx_pos = 0;
+}
+
+uint8_t net_get_route(uint8_t dst)
+{
+	uint8_t i;
+
+	for(i=0;i<NET_ROUTES;i++)
+		if(net_routes[i].via && net_routes[i].dst == dst)
+			return net_routes[i].via;
+	return 0;
+}
+
+/* via = 0 removes the route, returns the relay now in use */
+uint8_t net_set_route(uint8_t dst, uint8_t via)
+{
+	uint8_t i, free_slot = NET_ROUTES;
+
+	for(i=0;i<NET_ROUTES;i++)
+	{
+		if(net_routes[i].via && net_routes[i].dst == dst)
+		{
+			if(net_routes[i].via != via)
+			{
+				net_routes[i].via = via;
+				config_save();
+			}
+			return via;
+		}
+		if(!net_routes[i].via && free_slot == NET_ROUTES)
+			free_slot = i;
+	}
+	if(!via || free_slot == NET_ROUTES)
+		return 0;
+	net_routes[free_slot].dst = dst;
+	net_routes[free_slot].via = via;
+	config_save();
+	return via;
+}
+
+/* returns 1 if (src,seq) was seen before */
+static uint8_t net_duplicate(uint8_t src, uint8_t seq)
+{
+	uint16_t id = (src << 8) | seq;
+	uint8_t i;
+
+	for(i=0;i<NET_DUP_CACHE;i++)
+		if(dup_cache[i] == id)
+			return 1;
+	return 0;
+}
+
+static void net_remember(uint8_t src, uint8_t seq)
+{
+	dup_cache[dup_pos] = (src << 8) | seq;
+	if(++dup_pos == NET_DUP_CACHE)
+		dup_pos = 0;
+}
+
+/* wraps data (max. NET_MAX_PAYLOAD, AUTH_SIZE less if signed) in a
+ * network header and queues it for the link address via, returns the
+ * sequence number used or 0 if the frame was dropped */
+uint8_t net_frame(uint8_t type, uint8_t dst, uint8_t via, uint8_t *data, uint8_t len, uint8_t prio)
+{
+	struct net_header *hdr = (struct net_header*)tx_frame;
+	uint8_t size = len;
+
+#ifdef USE_AUTH
+	if(type & NET_FLAG_AUTH)
+		size += AUTH_SIZE;
+#endif
+	if(size > NET_MAX_PAYLOAD)
+	{
+		printf_P(PSTR("10;66;%d\r\n"),dst);
+		return 0;
+	}
+	hdr->magic = NET_MAGIC;
+	hdr->type = type;
+	hdr->dst = dst;
+	hdr->src = MY_ADDRESS;
+	/* 0 is left out, it means dropped */
+	if(!++tx_seq)
+		tx_seq++;
+	hdr->seq = tx_seq;
+	/* broadcasts and groups only reach the nodes in range */
+	hdr->ttl = NET_IS_MULTI(dst) ? 1 : NET_TTL;
+	hdr->hops = 0;
+	hdr->len = size;
+	if(data != &tx_frame[NET_HEADER_SIZE])
+		memcpy(&tx_frame[NET_HEADER_SIZE], data, len);
+#ifdef USE_AUTH
+	if(type & NET_FLAG_AUTH)
+		auth_sign(tx_frame);
+#endif
+	net_remember(MY_ADDRESS, hdr->seq);
+	if(!txq_put(via, tx_frame, NET_HEADER_SIZE + size, prio))
+		return 0;
+	return hdr->seq;
+}
+
+/* payload area of the frame net_frame() builds, callers that assemble
+ * a payload can write it there directly instead of into a buffer of
+ * their own; only valid until the next net_frame() */
+uint8_t *net_payload(void)
+{
+	return &tx_frame[NET_HEADER_SIZE];
+}
+
+/* always framed, also on a direct link */
+uint8_t net_send_type(uint8_t type, uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio)
+{
+	uint8_t via = net_get_route(dst);
+
+	return net_frame(type, dst, via ? via : dst, data, len, prio);
+}
+
+void net_send(uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio)
+{
+	uint8_t via = net_get_route(dst);
+
+	/* direct link (or too big for a relay), send it raw as always */
+	if(!via || len > NET_MAX_PAYLOAD)
+	{
+		txq_put(dst, data, len, prio);
+		return;
+	}
+	net_frame(NET_TYPE_DATA, dst, via, data, len, prio);
+}
+
+/* not one of our frames after all, hand the bytes on unchanged */
+static void net_rx_flush(void)
+{
+#ifndef AUTH_REQUIRED
+	uint8_t i;
+
+	for(i=0;i<rx_pos;i++)
+		uart_putc(rx_frame[i]);
+#endif
+	rx_pos = 0;
+}
+
+static void net_handle(void)
+{
+	struct net_header *hdr = (struct net_header*)rx_frame;
+	uint8_t i, via, tag;
+
+	if(net_duplicate(hdr->src, hdr->seq))
+		return;
+	net_received++;
+
+#ifdef USE_AUTH
+	/* relays keep the trailer, the final receiver checks it */
+	if(hdr->dst == MY_ADDRESS || hdr->dst == NET_BROADCAST)
+	{
+		if(hdr->type & NET_FLAG_AUTH)
+		{
+			if(!auth_check(rx_frame))
+			{
+				printf_P(PSTR("10;43;%d\r\n"),hdr->src);
+				return;
+			}
+			hdr->len -= AUTH_SIZE;
+		}
+#ifdef AUTH_REQUIRED
+		else
+		{
+			printf_P(PSTR("10;43;%d\r\n"),hdr->src);
+			return;
+		}
+#endif
+	}
+#endif
+	/* only now, a forged frame must not make the real one a duplicate */
+	net_remember(hdr->src, hdr->seq);
+
+	if(hdr->dst == MY_ADDRESS || hdr->dst == NET_BROADCAST)
+		rule_event(RULE_RF, hdr->src);
+
+	if(hdr->dst == MY_ADDRESS)
+	{
+		switch(hdr->type & NET_TYPE_MASK)
+		{
+			case NET_TYPE_POLL:
+				mailbox_deliver(hdr->src);
+				return;
+			case NET_TYPE_ACK:
+				if(hdr->len)
+					group_ack(hdr->src, rx_frame[NET_HEADER_SIZE]);
+				return;
+			case NET_TYPE_FRAG:
+				frag_rx(hdr->src, &rx_frame[NET_HEADER_SIZE], hdr->len);
+				return;
+			case NET_TYPE_OTA_ACK:
+				if(hdr->len >= 2)
+					ota_ack(hdr->src, (rx_frame[NET_HEADER_SIZE] << 8) | rx_frame[NET_HEADER_SIZE + 1]);
+				return;
+			case NET_TYPE_READING:
+				tag = tag_swap(tag_reply(hdr->src));
+				cache_rx(hdr->src, &rx_frame[NET_HEADER_SIZE], hdr->len);
+				tag_swap(tag);
+				return;
+		}
+	}
+	if(hdr->dst == MY_ADDRESS || hdr->dst == NET_BROADCAST)
+	{
+		tag = tag_swap(tag_reply(hdr->src));
+#ifdef USE_COMPRESSION
+		if(hdr->type & NET_FLAG_COMPRESSED)
+			comp_rx(hdr->src, hdr->seq, &rx_frame[NET_HEADER_SIZE], hdr->len);
+		else
+#endif
+		{
+			tag_line();
+			for(i=0;i<hdr->len;i++)
+				uart_putc(rx_frame[NET_HEADER_SIZE + i]);
+		}
+		tag_swap(tag);
+		return;
+	}
+
+	/* we are a hop on the way, pass it on */
+	if(hdr->ttl <= 1 || NET_IS_MULTI(hdr->dst))
+		return;
+	hdr->ttl--;
+	hdr->hops++;
+	via = net_get_route(hdr->dst);
+	txq_put(via ? via : hdr->dst, rx_frame, NET_HEADER_SIZE + hdr->len, TXQ_LOW);
+}
+
+/* 0 if header byte pos (just received) can't be part of one of our
+ * frames, so raw data that happens to start with NET_MAGIC is handed on
+ * at the first byte that doesn't fit */
+static uint8_t net_header_ok(uint8_t pos)
+{
+	struct net_header *hdr = (struct net_header*)rx_frame;
+
+	switch(pos)
+	{
+		case 1:	return (hdr->type & NET_TYPE_MASK) <= NET_TYPE_MAX;
+		case 3:	return hdr->src && !NET_IS_MULTI(hdr->src);
+		case 5:	return hdr->ttl && hdr->ttl <= NET_TTL;
+		/* relays move ttl over to hops, the sum never grows */
+		case 6:	return hdr->ttl + hdr->hops <= NET_TTL;
+		case 7:	return hdr->len <= NET_MAX_PAYLOAD;
+	}
+	return 1;
+}
+
+/* feed every byte received from the rfm12 in here */
+void net_rx(uint8_t c)
+{
+	struct net_header *hdr = (struct net_header*)rx_frame;
+
+	rx_idle = 0;
+	if(!rx_pos && c != NET_MAGIC)
+	{
+#ifndef AUTH_REQUIRED
+		uart_putc(c);
+#endif
+		return;
+	}
+	rx_frame[rx_pos] = c;
+	if(rx_pos < NET_HEADER_SIZE && !net_header_ok(rx_pos))
+	{
+		rx_pos++;
+		net_rx_flush();
+		return;
+	}
+	if(++rx_pos < NET_HEADER_SIZE)
+		return;
+
+	if(rx_pos == NET_HEADER_SIZE + hdr->len)
+	{
+		net_handle();
+		rx_pos = 0;
+	}
+}
+
+/* give up frames that stopped in the middle */
+void net_poll(void)
+{
+	if(rx_pos && rx_idle > NET_RX_TIMEOUT)
+		net_rx_flush();
+}
+
+/* called from the 100Hz timer */
+void net_tick(void)
+{
+	if(rx_idle < 255)
+		rx_idle++;
+}
@@ -0,0 +1,94 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_NET_H__
+#define __DEFINE_NET_H__
+
+/* Network header in front of the rf12 payload
+ *
+ * Frames without a route are still sent raw as before. Only frames
+ * that have to travel over a relay node get this header, so old nodes
+ * keep working unchanged.
+ *
+ * magic | type | dst | src | seq | ttl | hops | len | payload ...
+ */
+#define NET_MAGIC		0xA5
+#define NET_HEADER_SIZE	8
+#define NET_MAX_PAYLOAD	40		// largest payload that fits into one relayed frame
+#define NET_TTL			4		// hops a frame may travel before it is dropped
+#define NET_ROUTES		8		// entries in the next-hop table
+#define NET_DUP_CACHE	8		// remembered (src,seq) pairs
+#define NET_RX_TIMEOUT	5		// ticks (10ms) until a partial frame is given up
+
+#define NET_TYPE_DATA	0
+#define NET_TYPE_POLL	1		// node woke up, no payload
+#define NET_TYPE_MULTICAST	2	// member count, members ..., data
+#define NET_TYPE_ACK	3		// seq of the acknowledged frame
+#define NET_TYPE_FRAG	4		// part of a bigger frame, see frag.h
+#define NET_TYPE_OTA	5		// firmware block, see ota.h
+#define NET_TYPE_OTA_ACK	6	// next firmware block the node wants
+#define NET_TYPE_BEACON	7		// station clock, see beacon.h
+#define NET_TYPE_READING	8	// sensor values, see cache.h
+#define NET_TYPE_MAX	8
+#define NET_TYPE_MASK	0x0F
+#define NET_FLAG_ACK	0x10		// receivers answer with NET_TYPE_ACK
+#define NET_FLAG_COMPRESSED	0x20	// payload starts with a COMP_ method byte
+#define NET_FLAG_AT		0x40		// payload starts with the time to execute it
+#define NET_FLAG_AUTH	0x80		// counter and mac behind the payload, see auth.h
+
+/* addresses 0xF0-0xFE are multicast groups, 0xFF reaches everybody */
+#define NET_GROUP_FIRST	0xF0
+#define NET_GROUP_LAST	0xFE
+#define NET_BROADCAST	0xFF
+#define NET_IS_MULTI(a)	((a) >= NET_GROUP_FIRST)
+
+struct net_header {
+	uint8_t magic;
+	uint8_t type;
+	uint8_t dst;	// final destination
+	uint8_t src;	// originator
+	uint8_t seq;	// per originator, for duplicate detection
+	uint8_t ttl;
+	uint8_t hops;
+	uint8_t len;	// payload bytes following the header
+};
+
+/* next-hop table, kept in the config log (see config.h) */
+struct net_route {
+	uint8_t dst;
+	uint8_t via;	// 0 = slot unused
+};
+
+extern uint16_t net_received;	// frames handled since boot
+extern struct net_route net_routes[NET_ROUTES];
+
+extern void net_init(void);
+extern uint8_t *net_payload(void);
+extern uint8_t net_frame(uint8_t type, uint8_t dst, uint8_t via, uint8_t *data, uint8_t len, uint8_t prio);
+extern uint8_t net_send_type(uint8_t type, uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio);
+extern void net_send(uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio);
+extern void net_rx(uint8_t c);
+extern void net_poll(void);
+extern void net_tick(void);
+extern uint8_t net_set_route(uint8_t dst, uint8_t via);
+extern uint8_t net_get_route(uint8_t dst);
+
+#endif
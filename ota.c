@@ -0,0 +1,225 @@
+/* Over-the-air firmware distribution
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <util/crc16.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "main.h"
+#include "clock.h"
+#include "net.h"
+#include "pool.h"
+#include "txq.h"
+#include "frag.h"
+#include "ota.h"
+#include "tag.h"
+#include "config.h"
+
+struct ota {
+	uint8_t active;
+	uint8_t node;
+	uint16_t size;
+	uint16_t blocks;
+	uint16_t next_host;		// next block expected from the host
+	uint16_t acked;			// blocks in front of it are on the node
+	uint8_t probing;		// waiting for the node's resume point
+	uint8_t retries;
+	uint8_t in_window;
+	uint32_t start;
+	uint32_t last_tx;
+	uint8_t tag;
+	struct packet_list window;
+};
+
+static struct ota ota;
+
+void ota_init(void)
+{
+	ota.active = 0;
+	pool_list_init(&ota.window);
+}
+
+static void ota_free_window(void)
+{
+	uint8_t p;
+
+	while((p = pool_list_get(&ota.window)) != POOL_NONE)
+		pool_free(p);
+	ota.in_window = 0;
+}
+
+/* blocks the host may send right now */
+static uint8_t ota_credits(void)
+{
+	uint8_t free = pool_available();
+
+	if(!ota.active || ota.probing || ota.next_host >= ota.blocks)
+		return 0;
+	free = free > FRAG_RESERVE + 1 ? free - FRAG_RESERVE - 1 : 0;
+	return OTA_WINDOW - ota.in_window < free ? OTA_WINDOW - ota.in_window : free;
+}
+
+static void ota_report(void)
+{
+	printf_P(PSTR("10;38;%d;%u;%d\r\n"),ota.node,ota.next_host,ota_credits());
+}
+
+static void ota_probe(void)
+{
+	uint8_t probe[4];
+
+	probe[0] = OTA_PROBE >> 8;
+	probe[1] = OTA_PROBE & 0xFF;
+	probe[2] = ota.size >> 8;
+	probe[3] = ota.size & 0xFF;
+	net_send_type(NET_TYPE_OTA, ota.node, probe, sizeof(probe), TXQ_LOW);
+	ota.last_tx = clock_ms();
+}
+
+/* asks the node where to go on, a new image starts at block 0 */
+void ota_start(uint8_t node, uint16_t size)
+{
+	ota_free_window();
+	ota.active = 1;
+	ota.node = node;
+	ota.size = size;
+	ota.blocks = (size + OTA_BLOCK_SIZE - 1) / OTA_BLOCK_SIZE;
+	ota.next_host = 0;
+	ota.acked = 0;
+	ota.probing = 1;
+	ota.retries = 0;
+	ota.start = clock_ms();
+	ota.tag = tag_current;
+	ota_probe();
+}
+
+static void ota_send_window(void)
+{
+	uint8_t p;
+
+	for(p=ota.window.head;p!=POOL_NONE;p=pool[p].next)
+		net_send_type(NET_TYPE_OTA, ota.node, pool[p].data, pool[p].len, TXQ_LOW);
+	ota.last_tx = clock_ms();
+}
+
+void ota_block(uint16_t block, uint8_t *data, uint8_t len)
+{
+	uint16_t crc = 0xFFFF;
+	uint8_t i, p;
+
+	/* out of step, tell the host where we are */
+	if(block != ota.next_host || !ota_credits() || len > OTA_BLOCK_SIZE ||
+		(p = pool_alloc()) == POOL_NONE)
+	{
+		ota_report();
+		return;
+	}
+	for(i=0;i<len;i++)
+		crc = _crc_ccitt_update(crc, data[i]);
+	pool[p].dst = ota.node;
+	pool[p].len = 4 + len;
+	pool[p].data[0] = block >> 8;
+	pool[p].data[1] = block & 0xFF;
+	pool[p].data[2] = crc >> 8;
+	pool[p].data[3] = crc & 0xFF;
+	memcpy(&pool[p].data[4], data, len);
+	pool_list_put(&ota.window, p);
+	ota.in_window++;
+	ota.next_host++;
+
+	net_send_type(NET_TYPE_OTA, ota.node, pool[p].data, pool[p].len, TXQ_LOW);
+	ota.last_tx = clock_ms();
+	ota_report();
+}
+
+/* 10;40;node;bytes;ms;bytes/s;bytes/s the rf link could do at most */
+static void ota_done(void)
+{
+	uint32_t ms = clock_ms() - ota.start;
+
+	printf_P(PSTR("10;40;%d;%u;%lu;%lu;%u\r\n"),ota.node,ota.size,ms,
+		ms ? ota.size * 1000UL / ms : 0,(uint16_t)(config_get(CONFIG_RF_RATE)/8));
+	ota_free_window();
+	ota.active = 0;
+}
+
+void ota_ack(uint8_t node, uint16_t next)
+{
+	uint8_t p, tag;
+	uint16_t block;
+
+	if(!ota.active || node != ota.node || next > ota.blocks)
+		return;
+	tag = tag_swap(ota.tag);
+
+	if(ota.probing)
+	{
+		/* the node already has everything in front of next */
+		ota.probing = 0;
+		ota.acked = next;
+		ota.next_host = next;
+	}
+	while((p = ota.window.head) != POOL_NONE)
+	{
+		block = (pool[p].data[0] << 8) | pool[p].data[1];
+		if(block >= next)
+			break;
+		pool_list_get(&ota.window);
+		pool_free(p);
+		ota.in_window--;
+	}
+	if(next > ota.acked)
+	{
+		ota.acked = next;
+		ota.retries = 0;
+	}
+	if(ota.acked == ota.blocks)
+		ota_done();
+	else
+		ota_report();
+	tag_swap(tag);
+}
+
+/* go-back-n: everything not acknowledged in time is sent again */
+void ota_poll(void)
+{
+	uint8_t tag;
+
+	if(!ota.active || (!ota.probing && !ota.in_window) ||
+		clock_ms() - ota.last_tx < OTA_RETRY_MS)
+		return;
+
+	tag = tag_swap(ota.tag);
+	if(++ota.retries > OTA_RETRIES)
+	{
+		/* the host can pick up from here with a new start */
+		printf_P(PSTR("10;39;%d;%u\r\n"),ota.node,ota.acked);
+		ota_free_window();
+		ota.active = 0;
+	}
+	else if(ota.probing)
+		ota_probe();
+	else
+		ota_send_window();
+	tag_swap(tag);
+}
@@ -0,0 +1,48 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_OTA_H__
+#define __DEFINE_OTA_H__
+
+/* Firmware images for the nodes, streamed from the host through the
+ * packet pool
+ *
+ * NET_TYPE_OTA payload:     block (high, low) | crc16 (high, low) | data
+ *                           block 0xFFFF asks for the resume point and
+ *                           carries the image size instead of crc/data
+ * NET_TYPE_OTA_ACK payload: next block the node wants (high, low),
+ *                           everything in front of it arrived intact
+ *
+ * At most OTA_WINDOW blocks are on the way, the host gets a
+ * "10;38;node;next block;credits" whenever it may send more. */
+#define OTA_BLOCK_SIZE	32
+#define OTA_WINDOW		3		// blocks sent but not acknowledged
+#define OTA_RETRY_MS	500		// resend the window after this
+#define OTA_RETRIES		5		// give up after this many resends
+#define OTA_PROBE		0xFFFF
+
+extern void ota_init(void);
+extern void ota_start(uint8_t node, uint16_t size);
+extern void ota_block(uint16_t block, uint8_t *data, uint8_t len);
+extern void ota_ack(uint8_t node, uint16_t next);
+extern void ota_poll(void);
+
+#endif
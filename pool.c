@@ -0,0 +1,100 @@
+/* Packet memory
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+
+#include "net.h"
+#include "pool.h"
+
+struct packet pool[POOL_PACKETS];
+static struct packet_list free_list;
+static uint8_t free_count;
+
+void pool_init(void)
+{
+	uint8_t i;
+
+	pool_list_init(&free_list);
+	for(i=0;i<POOL_PACKETS;i++)
+		pool_list_put(&free_list, i);
+	free_count = POOL_PACKETS;
+}
+
+/* returns POOL_NONE if the memory is exhausted */
+uint8_t pool_alloc(void)
+{
+	uint8_t p = pool_list_get(&free_list);
+
+	if(p != POOL_NONE)
+		free_count--;
+	return p;
+}
+
+void pool_free(uint8_t p)
+{
+	pool_list_put(&free_list, p);
+	free_count++;
+}
+
+uint8_t pool_available(void)
+{
+	return free_count;
+}
+
+void pool_list_init(struct packet_list *list)
+{
+	list->head = POOL_NONE;
+	list->tail = POOL_NONE;
+}
+
+void pool_list_put(struct packet_list *list, uint8_t p)
+{
+	pool[p].next = POOL_NONE;
+	if(list->tail == POOL_NONE)
+		list->head = p;
+	else
+		pool[list->tail].next = p;
+	list->tail = p;
+}
+
+uint8_t pool_list_get(struct packet_list *list)
+{
+	uint8_t p = list->head;
+
+	if(p != POOL_NONE)
+	{
+		list->head = pool[p].next;
+		if(list->head == POOL_NONE)
+			list->tail = POOL_NONE;
+	}
+	return p;
+}
+
+/* unlink p, prev is the packet in front of it or POOL_NONE */
+void pool_list_remove(struct packet_list *list, uint8_t prev, uint8_t p)
+{
+	if(prev == POOL_NONE)
+		list->head = pool[p].next;
+	else
+		pool[prev].next = pool[p].next;
+	if(list->tail == p)
+		list->tail = prev;
+}
@@ -0,0 +1,57 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_POOL_H__
+#define __DEFINE_POOL_H__
+
+/* Fixed size packet memory shared by all queues of the station.
+ * Packets are chained by index, so a list costs two bytes. */
+#define POOL_PACKETS	8
+#define POOL_DATA_SIZE	(NET_HEADER_SIZE + NET_MAX_PAYLOAD)
+#define POOL_NONE		0xFF
+
+struct packet {
+	uint8_t next;		// next packet in the same list
+	uint8_t dst;
+	uint8_t len;
+	uint32_t stamp;		// clock_ms() when it was queued
+	uint8_t tag;		// host request it belongs to, see tag.h
+	uint8_t prio;		// TXQ_ class while it waits in a mailbox, | NET_FLAG_AUTH to be signed
+	uint8_t data[POOL_DATA_SIZE];
+};
+
+struct packet_list {
+	uint8_t head;
+	uint8_t tail;
+};
+
+extern struct packet pool[POOL_PACKETS];
+
+extern void pool_init(void);
+extern uint8_t pool_alloc(void);
+extern void pool_free(uint8_t p);
+extern uint8_t pool_available(void);
+extern void pool_list_init(struct packet_list *list);
+extern void pool_list_put(struct packet_list *list, uint8_t p);
+extern uint8_t pool_list_get(struct packet_list *list);
+extern void pool_list_remove(struct packet_list *list, uint8_t prev, uint8_t p);
+
+#endif
@@ -0,0 +1,109 @@
+/* Relay outputs with pulses and auto-off timers
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <avr/pgmspace.h>
+
+#include "relay.h"
+
+static volatile uint16_t remaining[8];	// ms until the relay goes off, 0 = stays
+static uint16_t autooff[8];				// 0 = no auto-off
+
+/* new = ((old & keep) | set) ^ toggle */
+static void relay_update(uint8_t keep, uint8_t set, uint8_t toggle)
+{
+	uint8_t old, now, i, sreg = SREG;
+
+	cli();
+	old = PORTC;
+	now = ((old & keep) | set) ^ toggle;
+	PORTC = now;
+	for(i=0;i<8;i++)
+	{
+		if(!(now & (1 << i)))
+			remaining[i] = 0;
+		else if(!(old & (1 << i)) || (set & (1 << i)))
+			remaining[i] = autooff[i];
+	}
+	SREG = sreg;
+}
+
+void relay_write(uint8_t value)
+{
+	relay_update(0, value, 0);
+}
+
+void relay_set(uint8_t mask)
+{
+	relay_update(0xFF, mask, 0);
+}
+
+void relay_clear(uint8_t mask)
+{
+	relay_update(~mask, 0, 0);
+}
+
+void relay_toggle(uint8_t mask)
+{
+	relay_update(0xFF, 0, mask);
+}
+
+/* on now, off again after ms. 0 would mean "stays on", a pulse of
+ * nothing does nothing. */
+void relay_pulse(uint8_t mask, uint16_t ms)
+{
+	uint8_t i, sreg = SREG;
+
+	if(!ms)
+		return;
+	cli();
+	PORTC |= mask;
+	for(i=0;i<8;i++)
+		if(mask & (1 << i))
+			remaining[i] = ms;
+	SREG = sreg;
+}
+
+void relay_autooff(uint8_t mask, uint16_t ms)
+{
+	uint8_t i;
+
+	for(i=0;i<8;i++)
+		if(mask & (1 << i))
+			autooff[i] = ms;
+}
+
+void relay_report(void)
+{
+	printf_P(PSTR("10;13;%d\r\n"),PORTC);
+}
+
+/* from the 1kHz clock */
+void relay_tick(void)
+{
+	uint8_t i;
+
+	for(i=0;i<8;i++)
+		if(remaining[i] && !--remaining[i])
+			PORTC &= ~(1 << i);
+}
@@ -0,0 +1,41 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_RELAY_H__
+#define __DEFINE_RELAY_H__
+
+/* Relays on PORTC
+ *
+ * All changes are done with interrupts off, the 1kHz clock interrupt
+ * switches relays off when their pulse or auto-off time is over. A
+ * relay with an auto-off time goes off that long after it was last
+ * switched on, whatever switched it on. Times are ms, max. 65535. */
+
+extern void relay_write(uint8_t value);
+extern void relay_set(uint8_t mask);
+extern void relay_clear(uint8_t mask);
+extern void relay_toggle(uint8_t mask);
+extern void relay_pulse(uint8_t mask, uint16_t ms);
+extern void relay_autooff(uint8_t mask, uint16_t ms);
+extern void relay_report(void);
+extern void relay_tick(void);
+
+#endif
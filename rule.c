@@ -0,0 +1,116 @@
+/* Local rules, input and rf events to actions
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "net.h"
+#include "txq.h"
+#include "relay.h"
+#include "buzzer.h"
+#include "rule.h"
+#include "telemetry.h"
+
+static struct rule ee_rules[RULES] EEMEM;
+
+/* data: event, arg, action, mask, param (high, low), payload ... */
+void rule_set(uint8_t index, uint8_t *data, uint8_t len)
+{
+	struct rule r;
+
+	if(index >= RULES)
+		return;
+	memset(&r, 0, sizeof(r));
+	r.event = RULE_NONE;
+	if(len >= 6)
+	{
+		r.event = data[0];
+		r.arg = data[1];
+		r.action = data[2];
+		r.mask = data[3];
+		r.param = (data[4] << 8) | data[5];
+		r.len = len - 6 > RULE_DATA ? RULE_DATA : len - 6;
+		memcpy(r.data, &data[6], r.len);
+	}
+	eeprom_write_block(&r, &ee_rules[index], sizeof(r));
+	rule_report(index);
+}
+
+/* 10;55;rule;event;arg;action;mask;param;len */
+void rule_report(uint8_t index)
+{
+	struct rule r;
+
+	if(index >= RULES)
+		return;
+	eeprom_read_block(&r, &ee_rules[index], sizeof(r));
+	printf_P(PSTR("10;55;%d;%d;%d;%d;%d;%u;%d\r\n"),index,r.event,r.arg,r.action,r.mask,r.param,r.len);
+}
+
+static void rule_fire(uint8_t index)
+{
+	struct rule r;
+
+	eeprom_read_block(&r, &ee_rules[index], sizeof(r));
+	switch(r.action)
+	{
+		case RULE_SET:		relay_set(r.mask); break;
+		case RULE_CLEAR:	relay_clear(r.mask); break;
+		case RULE_TOGGLE:	relay_toggle(r.mask); break;
+		case RULE_PULSE:	relay_pulse(r.mask, r.param); break;
+		case RULE_BEEP:		buzzer_beep(r.param); break;
+		case RULE_PATTERN:	buzzer_play(r.mask, r.param); break;
+		case RULE_SEND:
+			if(r.len <= RULE_DATA)
+				net_send(r.mask, r.data, r.len, TXQ_HIGH);
+			break;
+	}
+	fprintf_P(telemetry,PSTR("10;56;%d\r\n"),index);
+}
+
+/* only event and arg are read until a rule matches */
+void rule_event(uint8_t event, uint8_t arg)
+{
+	uint8_t i, e, a;
+
+	for(i=0;i<RULES;i++)
+	{
+		e = eeprom_read_byte(&ee_rules[i].event);
+		if(e != event)
+			continue;
+		a = eeprom_read_byte(&ee_rules[i].arg);
+		if(a == arg || (event == RULE_RF && !a))
+			rule_fire(i);
+	}
+}
+
+/* input bits PD3-PD6 before and after, set = open */
+void rule_inputs(uint8_t old, uint8_t now)
+{
+	uint8_t i;
+
+	for(i=0;i<4;i++)
+		if((old ^ now) & (1 << (i + 3)))
+			rule_event((now & (1 << (i + 3))) ? RULE_OPEN : RULE_CLOSE, i);
+}
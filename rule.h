@@ -0,0 +1,69 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_RULE_H__
+#define __DEFINE_RULE_H__
+
+/* Local rules
+ *
+ * A rule in the eeprom maps an event to an action, so the station
+ * reacts on its own within microseconds and without the host. All
+ * matching rules fire, each one prints "10;56;rule".
+ *
+ * Events:  RULE_OPEN / RULE_CLOSE  arg = input 0-3 (PD3-PD6)
+ *          RULE_RF                 arg = node a frame came from, 0 = any
+ * Actions: RULE_SET / RULE_CLEAR / RULE_TOGGLE  mask = relays
+ *          RULE_PULSE              mask = relays, param = ms
+ *          RULE_BEEP               param = ms
+ *          RULE_PATTERN            mask = buzzer pattern, param = repeats
+ *          RULE_SEND               mask = node, data[len] goes there */
+#define RULES			16
+#define RULE_DATA		4
+
+#define RULE_NONE		0xFF	// erased eeprom
+#define RULE_OPEN		0
+#define RULE_CLOSE		1
+#define RULE_RF			2
+
+#define RULE_SET		0
+#define RULE_CLEAR		1
+#define RULE_TOGGLE		2
+#define RULE_PULSE		3
+#define RULE_BEEP		4
+#define RULE_SEND		5
+#define RULE_PATTERN	6
+
+struct rule {
+	uint8_t event;
+	uint8_t arg;
+	uint8_t action;
+	uint8_t mask;
+	uint16_t param;
+	uint8_t len;
+	uint8_t data[RULE_DATA];
+};
+
+extern void rule_set(uint8_t index, uint8_t *data, uint8_t len);
+extern void rule_report(uint8_t index);
+extern void rule_inputs(uint8_t old, uint8_t now);
+extern void rule_event(uint8_t event, uint8_t arg);
+
+#endif
@@ -0,0 +1,108 @@
+/* RF sniffer with binary capture records
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <avr/pgmspace.h>
+
+#include "uart.h"
+#include "main.h"
+#include "clock.h"
+#include "net.h"
+#include "pool.h"
+#include "sniff.h"
+#include "telemetry.h"
+
+static uint8_t enabled;
+static uint8_t packet = POOL_NONE;	// holds the payload while sniffing
+static uint8_t pos;			// payload bytes in packet
+static uint8_t status;
+static uint32_t start, last;
+
+void sniff_config(uint8_t on)
+{
+	if(on && packet == POOL_NONE && (packet = pool_alloc()) == POOL_NONE)
+		on = 0;
+	if(!on && packet != POOL_NONE)
+	{
+		pool_free(packet);
+		packet = POOL_NONE;
+	}
+	printf_P(PSTR("10;51;%d\r\n"),on);
+	telemetry_baud(on ? SNIFF_BAUDRATE : 0);
+	enabled = on;
+	pos = 0;
+}
+
+uint8_t sniff_active(void)
+{
+	return enabled;
+}
+
+static void sniff_flush(void)
+{
+	uint8_t record[SNIFF_RECORD];
+
+	record[0] = SNIFF_SYNC;
+	record[1] = start >> 24;
+	record[2] = start >> 16;
+	record[3] = start >> 8;
+	record[4] = start;
+	record[5] = pos;
+	record[6] = SNIFF_NO_RSSI;
+	record[7] = status;
+	telemetry_write(record, SNIFF_RECORD);
+	telemetry_write(pool[packet].data, pos);
+	pos = 0;
+}
+
+void sniff_rx(uint8_t c)
+{
+	struct net_header *hdr = (struct net_header*)pool[packet].data;
+
+	last = clock_us();
+	if(!pos)
+	{
+		start = last;
+		status = SNIFF_CRC_OK;
+	}
+	if(pos == SNIFF_MAX)
+	{
+		status |= SNIFF_TRUNCATED;
+		return;
+	}
+	pool[packet].data[pos++] = c;
+
+	if(pos >= NET_HEADER_SIZE && hdr->magic == NET_MAGIC &&
+		(hdr->type & NET_TYPE_MASK) <= NET_TYPE_MAX && hdr->len <= NET_MAX_PAYLOAD &&
+		pos == NET_HEADER_SIZE + hdr->len)
+	{
+		status |= SNIFF_FRAMED;
+		sniff_flush();
+	}
+}
+
+/* raw frames end when the bytes stop */
+void sniff_poll(void)
+{
+	if(pos && clock_us() - last > SNIFF_GAP_US)
+		sniff_flush();
+}
@@ -0,0 +1,63 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_SNIFF_H__
+#define __DEFINE_SNIFF_H__
+
+/* Sniffer
+ *
+ * COMMAND_SET_SNIFFER 1 turns the station into a capture device. The
+ * telemetry uart (see telemetry.h) goes to SNIFF_BAUDRATE (UBRR 3, no
+ * error at 16MHz) and every frame the rf12 lib hands out is sent there
+ * as a binary record instead of being handled:
+ *
+ * SNIFF_SYNC | time in us (4 bytes, high first) | len | rssi | status | payload
+ *
+ * The rf12 lib only hands out frames that passed its own check, so
+ * SNIFF_CRC_OK is always set. It doesn't tell the signal strength
+ * either, rssi is always SNIFF_NO_RSSI. A frame ends where its network
+ * header says (SNIFF_FRAMED) or when no byte came for SNIFF_GAP_US.
+ *
+ * COMMAND_SET_SNIFFER 0 goes back to the normal rate. On the ATmega32
+ * telemetry is the host uart, so it has to be sent at the sniffer
+ * rate. Text lines keep coming in between, they never contain
+ * SNIFF_SYNC.
+ *
+ * The payload is collected in a pool packet (see pool.h) taken when
+ * the sniffer is switched on and given back when it goes off; with
+ * no packet free it stays off (10;51;0). */
+#define SNIFF_BAUDRATE	250000UL
+#define SNIFF_SYNC		0xFA
+#define SNIFF_MAX		POOL_DATA_SIZE	// longer frames are cut (SNIFF_TRUNCATED)
+#define SNIFF_GAP_US	2000
+#define SNIFF_NO_RSSI	0xFF
+#define SNIFF_RECORD	8		// bytes in front of the payload
+
+#define SNIFF_CRC_OK	0x01
+#define SNIFF_FRAMED	0x02	// valid network header, see net.h
+#define SNIFF_TRUNCATED	0x04
+
+extern void sniff_config(uint8_t on);
+extern uint8_t sniff_active(void);
+extern void sniff_rx(uint8_t c);
+extern void sniff_poll(void);
+
+#endif
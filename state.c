@@ -0,0 +1,110 @@
+/* Station state
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "uart.h"
+#include "clock.h"
+#include "lcd.h"
+#include "dash.h"
+#include "counter.h"
+#include "state.h"
+
+static uint8_t record[STATE_RECORD];
+static uint8_t mode;
+static uint16_t interval;
+static uint32_t last;
+
+/* fills record, returns 1 if it differs from the one sent before */
+static uint8_t state_build(void)
+{
+	uint8_t buf[STATE_RECORD], *p = buf;
+	uint32_t c[COUNTER_INPUTS];
+	uint8_t i;
+
+	*p++ = STATE_VERSION;
+	*p++ = counter_inputs() >> PD3;
+	*p++ = PORTC;
+	*p = 0;
+	if(!(PORTA & (1<<PA7)))
+		*p |= STATE_BACKLIGHT;
+	if(!(PORTD & (1<<PD7)))
+		*p |= STATE_BUZZER;
+	if(dash_active())
+		*p |= STATE_DASH;
+	p++;
+	counter_read(c);
+	for(i=0;i<COUNTER_INPUTS;i++)
+	{
+		*p++ = c[i] >> 24;
+		*p++ = c[i] >> 16;
+		*p++ = c[i] >> 8;
+		*p++ = c[i];
+	}
+	lcd_read((char*)p);
+
+	if(!memcmp(buf, record, STATE_RECORD))
+		return 0;
+	memcpy(record, buf, STATE_RECORD);
+	return 1;
+}
+
+static void state_send(void)
+{
+	printf_P(PSTR("10;62;%d;"),STATE_RECORD);
+	uart_write(record, STATE_RECORD);
+	printf_P(PSTR("\r\n"));
+	last = clock_ms();
+}
+
+void state_report(void)
+{
+	state_build();
+	state_send();
+}
+
+void state_subscribe(uint8_t m, uint16_t ms)
+{
+	mode = m <= STATE_ALWAYS ? m : STATE_OFF;
+	interval = ms < STATE_INTERVAL ? STATE_INTERVAL : ms;
+	printf_P(PSTR("10;63;%d;%u\r\n"),mode,interval);
+	/* start with the full picture */
+	if(mode)
+		state_report();
+}
+
+uint8_t state_subscribed(void)
+{
+	return mode != STATE_OFF;
+}
+
+void state_poll(void)
+{
+	if(!mode || clock_ms() - last < interval)
+		return;
+	if(state_build() || mode == STATE_ALWAYS)
+		state_send();
+	else
+		last = clock_ms();
+}
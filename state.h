@@ -0,0 +1,56 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_STATE_H__
+#define __DEFINE_STATE_H__
+
+/* Station state in one record
+ *
+ * COMMAND_GET_STATE answers "10;62;len;" followed by len binary bytes
+ * and "\r\n":
+ *
+ * STATE_VERSION | inputs | relays | flags | counters (4 x 4 bytes, high first) | LCD text (32)
+ *
+ * inputs are the debounced PD3-PD6 in bits 0-3 (1 = open), relays is
+ * PORTC. COMMAND_SUBSCRIBE sends the record by itself every interval
+ * ms (STATE_ALWAYS) or only if something changed since the last one
+ * (STATE_CHANGES), so all changes of an interval come as one record.
+ * While subscribed the per-edge lines 10;30-37 are left out. The
+ * answer to COMMAND_SUBSCRIBE is "10;63;mode;interval". */
+#define STATE_VERSION	1
+#define STATE_RECORD	(4 + 4 * COUNTER_INPUTS + LCD_CELLS)
+#define STATE_INTERVAL	100		// ms, shortest interval
+
+#define STATE_OFF		0
+#define STATE_CHANGES	1
+#define STATE_ALWAYS	2
+
+/* flags */
+#define STATE_BACKLIGHT	0x01
+#define STATE_BUZZER	0x02
+#define STATE_DASH		0x04	// a dashboard has the LCD
+
+extern void state_report(void);
+extern void state_subscribe(uint8_t mode, uint16_t interval);
+extern uint8_t state_subscribed(void);
+extern void state_poll(void);
+
+#endif
@@ -0,0 +1,116 @@
+/* Tagged host requests
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "uart.h"
+#include "tag.h"
+
+struct tag_node {
+	uint8_t node;
+	uint8_t tag;	// 0 = unused
+};
+
+uint8_t tag_current;
+static uint8_t line_start = 1;
+static struct tag_node nodes[TAG_NODES];
+static uint8_t victim;
+
+void tag_init(void)
+{
+	memset(nodes, 0, sizeof(nodes));
+	tag_current = 0;
+}
+
+/* "@tag;" for bytes that don't go through stdout */
+void tag_line(void)
+{
+	uint8_t t = tag_current;
+
+	if(!t)
+		return;
+	uart_putc('@');
+	if(t >= 100)
+		uart_putc('0' + t / 100);
+	if(t >= 10)
+		uart_putc('0' + t / 10 % 10);
+	uart_putc('0' + t % 10);
+	uart_putc(';');
+}
+
+/* stdout, puts the tag in front of every line */
+void tag_putc(unsigned char c)
+{
+	if(line_start)
+		tag_line();
+	line_start = (c == '\n');
+	uart_putc(c);
+}
+
+/* returns the tag that was current before */
+uint8_t tag_swap(uint8_t tag)
+{
+	uint8_t old = tag_current;
+
+	tag_current = tag;
+	return old;
+}
+
+/* a tagged frame just went out to node */
+void tag_sent(uint8_t node, uint8_t len, uint8_t tag)
+{
+	uint8_t i, old;
+
+	if(!tag)
+		return;
+	old = tag_swap(tag);
+	printf_P(PSTR("10;48;%d;%d\r\n"),node,len);
+	tag_swap(old);
+	for(i=0;i<TAG_NODES;i++)
+		if(nodes[i].tag && nodes[i].node == node)
+			break;
+	if(i == TAG_NODES)
+	{
+		i = victim;
+		if(++victim == TAG_NODES)
+			victim = 0;
+	}
+	nodes[i].node = node;
+	nodes[i].tag = tag;
+}
+
+/* tag for a reply from node, 0 if nothing was asked */
+uint8_t tag_reply(uint8_t node)
+{
+	uint8_t i, tag;
+
+	for(i=0;i<TAG_NODES;i++)
+		if(nodes[i].tag && nodes[i].node == node)
+		{
+			tag = nodes[i].tag;
+			nodes[i].tag = 0;
+			return tag;
+		}
+	return 0;
+}
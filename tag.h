@@ -0,0 +1,45 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_TAG_H__
+#define __DEFINE_TAG_H__
+
+/* Tagged host requests
+ *
+ * COMMAND_TAG carries a tag (1-255) and a complete host frame
+ * (destination, data). Every line printed while the station handles
+ * that frame starts with "@tag;", so do the reports that come later:
+ * "10;48;dst;len" when an RF frame of it went out, mailbox, fragment,
+ * group ack and firmware reports. The next framed reply of the node
+ * it went to gets the tag as well. Raw replies carry no sender and
+ * stay untagged. */
+#define TAG_NODES	8		// nodes with a reply outstanding
+
+extern uint8_t tag_current;	// 0 = untagged
+
+extern void tag_init(void);
+extern void tag_putc(unsigned char c);
+extern void tag_line(void);
+extern uint8_t tag_swap(uint8_t tag);
+extern void tag_sent(uint8_t node, uint8_t len, uint8_t tag);
+extern uint8_t tag_reply(uint8_t node);
+
+#endif
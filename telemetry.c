@@ -0,0 +1,76 @@
+/* Diagnostics channel
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <util/delay.h>
+
+#include "uart.h"
+#include "config.h"
+#include "telemetry.h"
+
+FILE *telemetry;
+
+/* after fdevopen() of stdout */
+#ifdef UDR1
+/* transmit only, RXD1 is PD2 and that is the INT0 irq of the RFM12 */
+static void telemetry_uart(uint16_t baudrate)
+{
+	uart1_init(baudrate);
+	UCSR1B &= ~(_BV(RXCIE1)|_BV(RXEN1));
+}
+#endif
+
+void telemetry_init(void)
+{
+#ifdef UDR1
+	telemetry_uart(UART_BAUD_SELECT(TELEMETRY_BAUDRATE, F_CPU));
+	telemetry = fdevopen((void*)uart1_putc,NULL);
+#else
+	telemetry = stdout;
+#endif
+}
+
+/* binary records, no tag in front */
+void telemetry_write(const uint8_t *data, uint8_t len)
+{
+#ifdef UDR1
+	while(len--)
+		uart1_putc(*data++);
+#else
+	uart_write(data, len);
+#endif
+}
+
+/* 0 = back to the normal rate, what is queued still goes out at the
+ * old one */
+void telemetry_baud(uint32_t rate)
+{
+#ifdef UDR1
+	uart1_flush();
+	_delay_ms(1);
+	telemetry_uart(UART_BAUD_SELECT(rate ? rate : TELEMETRY_BAUDRATE, F_CPU));
+#else
+	uart_flush();
+	_delay_ms(1);
+	uart_init(UART_BAUD_SELECT(rate ? rate : config_get(CONFIG_UART_RATE), F_CPU));
+#endif
+}
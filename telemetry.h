@@ -0,0 +1,45 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_TELEMETRY_H__
+#define __DEFINE_TELEMETRY_H__
+
+/* Diagnostics channel
+ *
+ * Statistics (10;20/21 airtime, 10;23 queues, 10;26 compression,
+ * 10;44 auth bench, 10;53 latency), rule traces (10;56)
+ * and sniffer records are written to telemetry. On parts with two
+ * usarts (make DUAL=1, an atmega324p) that is USART1 at
+ * TELEMETRY_BAUDRATE, so diagnostics never hold up the data path on
+ * USART0. On the ATmega32 it is stdout, as before.
+ *
+ * USART1 sits on PD2/PD3 there. PD2 stays the RFM12 irq, so only the
+ * transmitter is enabled. TXD1 takes PD3 away from input 0, see
+ * counter.h. */
+#define TELEMETRY_BAUDRATE	76800	// 57600 is 2.1% off at 16MHz
+
+extern FILE *telemetry;
+
+extern void telemetry_init(void);
+extern void telemetry_write(const uint8_t *data, uint8_t len);
+extern void telemetry_baud(uint32_t rate);
+
+#endif
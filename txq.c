@@ -0,0 +1,194 @@
+/* RF transmit queue
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#include <avr/io.h>
+#include <stdio.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+#include "rf12.h"
+#include "clock.h"
+#include "net.h"
+#include "pool.h"
+#include "airtime.h"
+#include "beacon.h"
+#include "tag.h"
+#include "txq.h"
+#include "telemetry.h"
+
+struct txq_class {
+	struct packet_list queue;
+	uint8_t queued;
+	uint16_t frames;	// sent since boot
+	uint32_t delay;		// sum of queueing delays, ms
+	uint16_t delay_max;	// ms
+};
+
+static struct txq_class classes[TXQ_CLASSES];
+static uint8_t high_run;	// high frames sent in a row while low ones wait
+
+void txq_init(void)
+{
+	uint8_t i;
+
+	memset(classes, 0, sizeof(classes));
+	for(i=0;i<TXQ_CLASSES;i++)
+		pool_list_init(&classes[i].queue);
+	high_run = 0;
+}
+
+/* dst is the link address the rf12 lib sends to, returns 0 if the
+ * frame was dropped */
+uint8_t txq_put(uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio)
+{
+	uint8_t p;
+
+	if(!airtime_fits(len))
+	{
+		airtime_reject(dst);
+		return 0;
+	}
+	/* bigger frames are fragmented before they get here */
+	if(len > POOL_DATA_SIZE || (p = pool_alloc()) == POOL_NONE)
+	{
+		printf_P(PSTR("10;22;%d\r\n"),dst);
+		return 0;
+	}
+	pool[p].dst = dst;
+	pool[p].len = len;
+	pool[p].stamp = clock_ms();
+	pool[p].tag = tag_current;
+	/* data may be a packet that was just freed (and p the very same) */
+	memmove(pool[p].data, data, len);
+	if(prio >= TXQ_CLASSES)
+		prio = TXQ_HIGH;
+	pool_list_put(&classes[prio].queue, p);
+	classes[prio].queued++;
+	return 1;
+}
+
+/* 1 if an older frame for the same destination is still waiting */
+static uint8_t txq_blocked(struct txq_class *c, uint8_t p)
+{
+	uint8_t q;
+
+	for(q=c->queue.head;q!=p;q=pool[q].next)
+		if(pool[q].dst == pool[p].dst)
+			return 1;
+	return 0;
+}
+
+static void txq_remove(struct txq_class *c, uint8_t prev, uint8_t p)
+{
+	pool_list_remove(&c->queue, prev, p);
+	c->queued--;
+}
+
+/* sends (or rejects) at most one frame of the class, frames for a
+ * destination that is out of tokens don't hold up the others */
+static uint8_t txq_service(struct txq_class *c)
+{
+	struct net_header *hdr;
+	uint8_t p, prev = POOL_NONE, tag;
+	uint32_t delay;
+
+	for(p=c->queue.head;p!=POOL_NONE;prev=p,p=pool[p].next)
+	{
+		if(txq_blocked(c, p))
+			continue;
+		if(airtime_grant(pool[p].dst, pool[p].len))
+		{
+			txq_remove(c, prev, p);
+			delay = clock_ms() - pool[p].stamp;
+			if(delay > 0xFFFF)
+				delay = 0xFFFF;
+			c->frames++;
+			c->delay += delay;
+			if(delay > c->delay_max)
+				c->delay_max = delay;
+			beacon_stamp(pool[p].data, pool[p].len);
+			rf12_txpacket(pool[p].data, pool[p].len, pool[p].dst, 0);
+			/* a reply comes from the final destination, not the relay */
+			hdr = (struct net_header*)pool[p].data;
+			if(pool[p].len >= NET_HEADER_SIZE && hdr->magic == NET_MAGIC)
+				tag_sent(hdr->dst, pool[p].len, pool[p].tag);
+			else
+				tag_sent(pool[p].dst, pool[p].len, pool[p].tag);
+			pool_free(p);
+			return 1;
+		}
+		/* the limits may have been lowered since it was queued */
+		if(airtime_limits.policy == AIRTIME_REJECT || !airtime_fits(pool[p].len))
+		{
+			txq_remove(c, prev, p);
+			tag = tag_swap(pool[p].tag);
+			airtime_reject(pool[p].dst);
+			tag_swap(tag);
+			pool_free(p);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* high priority first. A low frame gets its turn after TXQ_HIGH_RUN
+ * high ones or when it has waited longer than TXQ_STARVE_MS. */
+void txq_poll(void)
+{
+	struct txq_class *low = &classes[TXQ_LOW];
+	struct txq_class *high = &classes[TXQ_HIGH];
+	uint8_t p = low->queue.head;
+
+	if(p != POOL_NONE && (high_run >= TXQ_HIGH_RUN ||
+		clock_ms() - pool[p].stamp > TXQ_STARVE_MS))
+	{
+		if(txq_service(low))
+		{
+			high_run = 0;
+			return;
+		}
+	}
+	if(txq_service(high))
+	{
+		if(low->queued)
+			high_run++;
+		return;
+	}
+	if(txq_service(low))
+		high_run = 0;
+}
+
+/* frames sent since boot */
+uint16_t txq_sent(void)
+{
+	return classes[TXQ_LOW].frames + classes[TXQ_HIGH].frames;
+}
+
+/* 10;23;class;frames;average delay ms;max delay ms;queued */
+void txq_report(void)
+{
+	uint8_t i;
+
+	for(i=0;i<TXQ_CLASSES;i++)
+		fprintf_P(telemetry,PSTR("10;23;%d;%u;%lu;%u;%d\r\n"),i,classes[i].frames,
+			classes[i].frames ? classes[i].delay / classes[i].frames : 0,
+			classes[i].delay_max,classes[i].queued);
+}
@@ -0,0 +1,39 @@
+/* Base station for RFM12
+ *
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public
+ * License along with this program; if not, write to the
+ * Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+ * Boston, MA 02111-1307, USA.
+ *
+ */
+
+#ifndef __DEFINE_TXQ_H__
+#define __DEFINE_TXQ_H__
+
+/* Everything that goes over the air passes this queue, frames leave
+ * it as soon as the airtime buckets allow. */
+#define TXQ_LOW			0		// bulk, lcd text, sensor polls
+#define TXQ_HIGH		1		// actuator commands
+#define TXQ_CLASSES		2
+#define TXQ_HIGH_RUN	4		// high frames in a row before a waiting low one goes
+#define TXQ_STARVE_MS	500		// low frames waiting longer than this go next
+
+extern void txq_init(void);
+extern uint8_t txq_put(uint8_t dst, uint8_t *data, uint8_t len, uint8_t prio);
+extern void txq_poll(void);
+extern void txq_report(void);
+extern uint16_t txq_sent(void);
+
+#endif
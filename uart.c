@@ -157,6 +157,8 @@ NOTES:
  #define TXCIE 			TXCIE0
  #define RXEN 			RXEN0
  #define TXEN 			TXEN0
+ #define RXC 			RXC0
+ #define UDRE 			UDRE0
  #define ATMEGA_USART0
  #define ATMEGA_USART1
  #define UART0_RECEIVE_INTERRUPT   SIG_USART_RECV
@@ -599,14 +601,25 @@ void uart_putc(unsigned char data)
 	UART0_DATA=data;
 
 #else
-    unsigned char tmphead;
+    unsigned char tmphead, sreg = SREG;
+	/* interrupts write here too (printf, cut-through) */
+	cli();
     tmphead  = (UART_TxHead + 1);
 	if (tmphead>=UART_TX_BUFFER_SIZE)
 		tmphead=0;
-    while ( tmphead == UART_TxTail ); // wait for free space in buffer   
+	while ( tmphead == UART_TxTail )	// wait for free space in buffer
+	{
+		SREG = sreg;
+		while ( tmphead == UART_TxTail );
+		cli();
+		tmphead  = (UART_TxHead + 1);
+		if (tmphead>=UART_TX_BUFFER_SIZE)
+			tmphead=0;
+	}
     UART_TxBuf[tmphead] = data;
     UART_TxHead = tmphead;
     UART0_CONTROL |= _BV(UART0_UDRIE);    // enable UDRE interrupt
+	SREG = sreg;
 #endif
 }/* uart_putc */
 #endif
@@ -639,6 +652,80 @@ void uart_puts_p(const char *progmem_s )
       uart_putc(c);
 
 }/* uart_puts_p */
+
+/*************************************************************************
+Function: uart_write()
+Purpose:  copy a block into the ringbuffer, the UDRE interrupt is
+          enabled once for the whole block
+Input:    data and number of bytes
+Returns:  none
+**************************************************************************/
+void uart_write(const unsigned char *data, unsigned char len)
+{
+#ifdef DISABLE_TXBUF
+	while (len--)
+		uart_putc(*data++);
+#else
+    unsigned char head, next, sreg = SREG;
+	cli();
+	head = UART_TxHead;
+	while (len--)
+	{
+		next = head + 1;
+		if (next>=UART_TX_BUFFER_SIZE)
+			next=0;
+		while (next == UART_TxTail)
+		{
+			/* buffer full, let the interrupt send what we have */
+			UART_TxHead = head;
+			UART0_CONTROL |= _BV(UART0_UDRIE);
+			SREG = sreg;
+			while ( next == UART_TxTail );
+			cli();
+			head = UART_TxHead;
+			next = head + 1;
+			if (next>=UART_TX_BUFFER_SIZE)
+				next=0;
+		}
+		UART_TxBuf[next] = *data++;
+		head = next;
+	}
+	UART_TxHead = head;
+	UART0_CONTROL |= _BV(UART0_UDRIE);    // enable UDRE interrupt
+	SREG = sreg;
+#endif
+}/* uart_write */
+
+/*************************************************************************
+Function: uart_tx_free()
+Purpose:  free bytes in the transmit ringbuffer, for writers that must
+          not block (interrupts)
+Input:    none
+Returns:  number of bytes
+**************************************************************************/
+unsigned char uart_tx_free(void)
+{
+#ifdef DISABLE_TXBUF
+	return (UART0_STATUS&(1<<UDRE)) ? 1 : 0;
+#else
+	return (UART_TxTail - UART_TxHead - 1) & (UART_TX_BUFFER_SIZE - 1);
+#endif
+}/* uart_tx_free */
+
+/*************************************************************************
+Function: uart_flush()
+Purpose:  wait until the ringbuffer is empty and the last byte is in
+          the shift register
+Input:    none
+Returns:  none
+**************************************************************************/
+void uart_flush(void)
+{
+#ifndef DISABLE_TXBUF
+	while ( UART_TxHead != UART_TxTail );
+#endif
+	while (!(UART0_STATUS&(1<<UDRE)));
+}/* uart_flush */
 #endif
 #ifdef ENABLE_RX
 unsigned char uart_getchar(void)
@@ -853,6 +940,20 @@ void uart1_puts_p(const char *progmem_s )
 }/* uart1_puts_p */
 
 
+/*************************************************************************
+Function: uart1_flush()
+Purpose:  wait until the ringbuffer of UART1 is empty and the last byte
+          is in the shift register
+Input:    none
+Returns:  none
+**************************************************************************/
+void uart1_flush(void)
+{
+	while ( UART1_TxHead != UART1_TxTail );
+	while (!(UART1_STATUS&(1<<UDRE1)));
+}/* uart1_flush */
+
+
 #endif
 
 
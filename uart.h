@@ -60,7 +60,7 @@ Usage:    see Doxygen manual
 
 
 /** Size of the circular receive buffer, must be power of 2 */
-#define UART_RX_BUFFER_SIZE 256
+#define UART_RX_BUFFER_SIZE 128
 /** Size of the circular transmit buffer, must be power of 2 */
 #define UART_TX_BUFFER_SIZE 128
 
@@ -68,7 +68,7 @@ Usage:    see Doxygen manual
 /** Size of the circular receive buffer, must be power of 2 */
 #define UART1_RX_BUFFER_SIZE 32
 /** Size of the circular transmit buffer, must be power of 2 */
-#define UART1_TX_BUFFER_SIZE 32
+#define UART1_TX_BUFFER_SIZE 64
 
 
 #ifndef P
@@ -158,6 +158,38 @@ extern void uart_puts(const char *s );
  */
 extern void uart_puts_p(const char *s );
 
+/**
+ * @brief    Put a block of bytes into the ringbuffer for transmitting via UART
+ *
+ * Same as calling uart_putc() for every byte, but the buffer index is
+ * only stored and the interrupt enabled once for the whole block.
+ * Blocks if the buffer is full.
+ *
+ * @param    data bytes to be transmitted
+ * @param    len number of bytes
+ * @return   none
+ */
+extern void uart_write(const unsigned char *data, unsigned char len);
+
+/**
+ * @brief    Wait until all buffered bytes have been handed to the UART
+ *
+ * The last byte may still be shifted out when this returns.
+ *
+ * @return   none
+ */
+extern void uart_flush(void);
+
+/**
+ * @brief    Free space in the transmit ringbuffer
+ *
+ * uart_putc() doesn't block while this is not 0, so it can be used in
+ * interrupts.
+ *
+ * @return   number of bytes
+ */
+extern unsigned char uart_tx_free(void);
+
 /**
  * @brief    Macro to automatically put a string constant into program memory
  */
@@ -178,6 +210,7 @@ extern unsigned int uart1_getc(void);
 extern void uart1_putc(unsigned char data);
 extern void uart1_puts(const char *s );
 extern void uart1_puts_p(const char *s );
+extern void uart1_flush(void);
 #define uart1_puts_P(__s)       uart1_puts_p(P(__s))
 
 